@@ -0,0 +1,78 @@
+#include <Inc/Bits.h>
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    template<typename T, std::size_t count>
+    MyECS::Bits<T, count> RandomBits(double density, uint32_t seed)
+    {
+        MyECS::Bits<T, count> result;
+        std::mt19937 generator{seed};
+        std::bernoulli_distribution distribution{density};
+
+        for(std::size_t i{0}; i<count; ++i)
+            if(distribution(generator))
+                result.Set(i);
+
+        return result;
+    }
+}
+
+///scans sparsely populated entity-wide bitset for set bits
+template<typename T>
+static void BM_OnesScan(benchmark::State& state)
+{
+    const auto bits = RandomBits<T, ENTITY_COUNT>(static_cast<double>(state.range(0)) / 100.0, 42);
+
+    for(auto _ : state)
+    {
+        uint64_t sum{0};
+        for(const auto bit : bits.Ones())
+            sum += bit;
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+template<typename T, std::size_t count>
+static void BM_DoesAndEqualThis(benchmark::State& state)
+{
+    const auto mask = RandomBits<T, count>(0.25, 42);
+    auto other = mask;
+    other |= RandomBits<T, count>(0.25, 7);
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(mask.DoesAndEqualThis(other));
+}
+
+template<typename T, std::size_t count>
+static void BM_OrAssign(benchmark::State& state)
+{
+    auto lhs = RandomBits<T, count>(0.25, 42);
+    const auto rhs = RandomBits<T, count>(0.25, 7);
+
+    for(auto _ : state)
+    {
+        lhs |= rhs;
+        benchmark::DoNotOptimize(lhs);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_OnesScan, BitsStorageType)->Arg(1)->Arg(10)->Arg(50);
+BENCHMARK_TEMPLATE(BM_OnesScan, uint64_t)->Arg(1)->Arg(10)->Arg(50);
+
+BENCHMARK_TEMPLATE(BM_DoesAndEqualThis, BitsStorageType, COMPONENTS_COUNT);
+BENCHMARK_TEMPLATE(BM_DoesAndEqualThis, uint64_t, 256);
+BENCHMARK_TEMPLATE(BM_DoesAndEqualThis, BitsStorageType, ENTITY_COUNT);
+
+BENCHMARK_TEMPLATE(BM_OrAssign, BitsStorageType, COMPONENTS_COUNT);
+BENCHMARK_TEMPLATE(BM_OrAssign, uint64_t, 256);
+BENCHMARK_TEMPLATE(BM_OrAssign, BitsStorageType, ENTITY_COUNT);
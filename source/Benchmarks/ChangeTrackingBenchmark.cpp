@@ -0,0 +1,93 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+#include <random>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    struct Velocity
+    {
+        float x{0.0f}, y{0.0f}, z{0.0f};
+
+        bool operator==(const Velocity&) const = default;
+    };
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+
+    std::unique_ptr<Manager> MakeWorld(bool trackChanges)
+    {
+        auto man = std::make_unique<Manager>();
+        if(trackChanges)
+            man->EnableChangeTracking<false, Velocity>();
+
+        man->CreateEntities<false, Velocity>(ENTITY_COUNT, [](std::size_t){ return std::tuple<Velocity>{}; });
+
+        return man;
+    }
+
+    ///entities changed every tick, state.range(0) per mille of all entities
+    std::vector<MyECS::Entity> PickChanged(const Manager& man, int64_t perMille)
+    {
+        std::vector<MyECS::Entity> changed;
+        std::sample(man.GetAliveEntities().begin(), man.GetAliveEntities().end(), std::back_inserter(changed),
+                    ENTITY_COUNT * perMille / 1000, std::mt19937{42});
+
+        return changed;
+    }
+}
+
+///replication without change tracking, every component is compared against copy sent previous tick
+static void BM_DiffAllComponents(benchmark::State& state)
+{
+    const auto man = MakeWorld(false);
+    const auto changed = PickChanged(*man, state.range(0));
+    const auto& velocities = std::as_const(*man).GetComponents<false, Velocity>();
+    std::vector<Velocity> sent(velocities.begin(), velocities.end());
+    std::vector<MyECS::Entity> toSend;
+
+    for(auto _ : state)
+    {
+        for(const auto entity : changed)
+            std::get<0>(man->GetEntityComponents<Velocity>(entity)).x += 1.0f;
+
+        // components were added in the order of alive entities and nothing was removed
+        toSend.clear();
+        for(std::size_t i{0}; i<velocities.size(); ++i)
+            if(!(velocities[i] == sent[i]))
+            {
+                sent[i] = velocities[i];
+                toSend.push_back(man->GetAliveEntities()[i]);
+            }
+
+        benchmark::DoNotOptimize(toSend.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * changed.size());
+}
+
+static void BM_CollectChanges(benchmark::State& state)
+{
+    const auto man = MakeWorld(true);
+    const auto changed = PickChanged(*man, state.range(0));
+    MyECS::ChangeSet changes;
+
+    for(auto _ : state)
+    {
+        const auto since = man->GetChangeTick();
+        man->AdvanceChangeTick();
+
+        for(const auto entity : changed)
+            std::get<0>(man->GetEntityComponents<Velocity>(entity)).x += 1.0f;
+
+        man->CollectChanges(since, changes);
+        benchmark::DoNotOptimize(changes.changed.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * changed.size());
+}
+
+BENCHMARK(BM_DiffAllComponents)->Arg(1)->Arg(30)->Arg(300)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CollectChanges)->Arg(1)->Arg(30)->Arg(300)->Unit(benchmark::kMicrosecond);
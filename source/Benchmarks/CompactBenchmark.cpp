@@ -0,0 +1,93 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+#include <random>
+
+#define ENTITY_COUNT 262144
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    struct Position
+    {
+        float x{0.0f}, y{0.0f}, z{0.0f};
+    };
+
+    struct Velocity
+    {
+        float x{1.0f}, y{1.0f}, z{1.0f};
+    };
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+
+    ///world after rounds of removing random entities and respawning them, Velocity is added separately
+    ///so instances of the two storages end up in unrelated orders
+    std::unique_ptr<Manager> MakeChurnedWorld()
+    {
+        auto man = std::make_unique<Manager>();
+        std::vector<MyECS::Entity> entities;
+        for(std::size_t i{0}; i<ENTITY_COUNT; ++i)
+            entities.push_back(man->CreateEntity<false, Position>(Position{}));
+
+        std::mt19937 random{42};
+        for(int round{0}; round<4; ++round)
+        {
+            std::shuffle(entities.begin(), entities.end(), random);
+            for(std::size_t i{0}; i<ENTITY_COUNT/2; ++i)
+            {
+                man->RemoveEntity(entities[i]);
+                entities[i] = man->CreateEntity<false, Position>(Position{});
+            }
+        }
+
+        std::shuffle(entities.begin(), entities.end(), random);
+        for(const auto entity : entities)
+            man->AddComponents<false, Velocity>(entity, Velocity{});
+
+        return man;
+    }
+}
+
+///Position and Velocity join, state.range(0) is 1 when storages were compacted
+static void BM_JoinAfterChurn(benchmark::State& state)
+{
+    const auto man = MakeChurnedWorld();
+    if(state.range(0))
+        man->Compact();
+
+    for(auto _ : state)
+    {
+        for(auto [entity, position, velocity] : man->GetView<Position, Velocity>())
+        {
+            position.x += velocity.x;
+            position.y += velocity.y;
+            position.z += velocity.z;
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+///incremental pass spread over frames, state.range(0) entities per step
+static void BM_DefragmentStep(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto man = MakeChurnedWorld();
+        state.ResumeTiming();
+
+        while(!man->DefragmentStep(static_cast<std::size_t>(state.range(0))));
+
+        state.PauseTiming();
+        man.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT * 2);
+}
+
+BENCHMARK(BM_JoinAfterChurn)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DefragmentStep)->Arg(1024)->Arg(65536)->Unit(benchmark::kMillisecond);
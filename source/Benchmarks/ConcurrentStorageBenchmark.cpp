@@ -0,0 +1,114 @@
+#include <Inc/ComponentStorage.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    struct Transform
+    {
+        Transform() { mat4.fill(0.0f); }
+
+        std::array<float, 16> mat4;
+        bool transposed{false};
+    };
+
+    using SharedLockStorage = MyECS::ComponentsStorage<COMPONENTS_COUNT, BitsStorageType, Transform, true>;
+
+    ///previous thread safe storage (one exclusive mutex for readers and writers), kept as a reference point
+    struct ExclusiveLockStorage
+    {
+        void AddComponentInstance(MyECS::Entity entity, Transform&& instance)
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            _storage.AddComponentInstance(entity, std::move(instance));
+        }
+
+        template<typename Fn>
+        decltype(auto) Read(MyECS::Entity entity, Fn&& fn) const
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            return fn(_storage.GetByEntity(entity));
+        }
+
+        template<typename Fn>
+        decltype(auto) Write(MyECS::Entity entity, Fn&& fn)
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            return fn(_storage.GetByEntity(entity));
+        }
+
+        mutable std::mutex _mutex;
+        MyECS::ComponentsStorage<COMPONENTS_COUNT, BitsStorageType, Transform, false> _storage;
+    };
+
+    template<typename Storage>
+    Storage& SharedStorage()
+    {
+        static const auto storage = []{
+            auto result = std::make_unique<Storage>();
+            for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; ++entity)
+                result->AddComponentInstance(entity, Transform{});
+            return result;
+        }();
+
+        return *storage;
+    }
+
+    std::vector<MyECS::Entity> ShuffledEntities(uint32_t seed)
+    {
+        std::vector<MyECS::Entity> entities(ENTITY_COUNT);
+        std::iota(entities.begin(), entities.end(), 0);
+        std::shuffle(entities.begin(), entities.end(), std::mt19937{seed});
+
+        return entities;
+    }
+}
+
+///every thread reads components of all entities in its own random order
+template<typename Storage>
+static void BM_ConcurrentRead(benchmark::State& state)
+{
+    auto& storage = SharedStorage<Storage>();
+    const auto entities = ShuffledEntities(42 + state.thread_index());
+
+    for(auto _ : state)
+        for(const auto entity : entities)
+            benchmark::DoNotOptimize(storage.Read(entity, [](const Transform& transform){ return transform.mat4[0]; }));
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+///same as above, but thread 0 writes instead of reading (many systems read Transform, one writes it),
+///only reads are counted as processed items
+template<typename Storage>
+static void BM_ConcurrentReadOneWriter(benchmark::State& state)
+{
+    auto& storage = SharedStorage<Storage>();
+    const auto entities = ShuffledEntities(42 + state.thread_index());
+    const bool writer = state.thread_index() == 0;
+
+    for(auto _ : state)
+        for(const auto entity : entities)
+        {
+            if(writer)
+                storage.Write(entity, [](Transform& transform){ transform.mat4[0] += 1.0f; });
+            else
+                benchmark::DoNotOptimize(storage.Read(entity, [](const Transform& transform){ return transform.mat4[0]; }));
+        }
+
+    if(!writer)
+        state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+BENCHMARK_TEMPLATE(BM_ConcurrentRead, ExclusiveLockStorage)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentRead, SharedLockStorage)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_ConcurrentReadOneWriter, ExclusiveLockStorage)->ThreadRange(2, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentReadOneWriter, SharedLockStorage)->ThreadRange(2, 8)->UseRealTime();
@@ -0,0 +1,261 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+///core EntityManager operations over 1k..1M entities, swept over BitsStorageType widths, components capacity
+///and storage kind, run with --benchmark_out=<file> --benchmark_out_format=json (or the benchmark_json target)
+///to keep results comparable between releases
+
+namespace
+{
+    struct Position
+    {
+        float x{0.0f}, y{0.0f}, z{0.0f};
+    };
+
+    struct Velocity
+    {
+        float x{0.0f}, y{0.0f}, z{0.0f};
+    };
+
+    struct Health
+    {
+        int value{100};
+    };
+
+    template<typename BitsStorageType, std::size_t components_capacity = 64>
+    using Manager = MyECS::EntityManager<MyECS::MaxEntitiesCount, components_capacity, BitsStorageType>;
+
+    template<typename ManagerType, bool ThreadSafeComponents>
+    std::unique_ptr<ManagerType> MakeWorld(std::size_t count)
+    {
+        auto man = std::make_unique<ManagerType>();
+        man->template CreateEntities<ThreadSafeComponents, Position, Velocity>(count, [](std::size_t){
+            return std::tuple<Position, Velocity>{};
+        });
+
+        return man;
+    }
+
+    template<typename BitsStorageType>
+    struct MovementSystem : public MyECS::System<64, BitsStorageType>
+    {
+        MovementSystem() : MyECS::System<64, BitsStorageType>(MyECS::SystemComponents<Position, Health>{}) {}
+    };
+
+    void EntityCounts(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->RangeMultiplier(10)->Range(1'000, 1'000'000)->Unit(benchmark::kMicrosecond);
+    }
+}
+
+template<typename ManagerType, bool ThreadSafeComponents, typename ...Components>
+static void BM_CreateEntity(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto man = std::make_unique<ManagerType>();
+        state.ResumeTiming();
+
+        for(std::size_t i{0}; i<count; ++i)
+            man->template CreateEntity<ThreadSafeComponents, Components...>(Components{}...);
+
+        benchmark::DoNotOptimize(man.get());
+
+        state.PauseTiming();
+        man.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template<typename ManagerType, bool ThreadSafeComponents>
+static void BM_AddComponents(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto man = MakeWorld<ManagerType, ThreadSafeComponents>(count);
+        const std::vector<MyECS::Entity> entities(man->GetAliveEntities().begin(), man->GetAliveEntities().end());
+        state.ResumeTiming();
+
+        for(const auto entity : entities)
+            man->template AddComponents<ThreadSafeComponents, Health>(entity, Health{});
+
+        state.PauseTiming();
+        man.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template<typename ManagerType, bool ThreadSafeComponents>
+static void BM_DetachComponents(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto man = MakeWorld<ManagerType, ThreadSafeComponents>(count);
+        const std::vector<MyECS::Entity> entities(man->GetAliveEntities().begin(), man->GetAliveEntities().end());
+        state.ResumeTiming();
+
+        for(const auto entity : entities)
+            man->template DetachComponents<Velocity>(entity);
+
+        state.PauseTiming();
+        man.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template<typename ManagerType, bool ThreadSafeComponents>
+static void BM_RemoveEntity(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto man = MakeWorld<ManagerType, ThreadSafeComponents>(count);
+        const std::vector<MyECS::Entity> entities(man->GetAliveEntities().begin(), man->GetAliveEntities().end());
+        state.ResumeTiming();
+
+        for(const auto entity : entities)
+            man->RemoveEntity(entity);
+
+        state.PauseTiming();
+        man.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template<typename ManagerType>
+static void BM_HasComponents(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto man = MakeWorld<ManagerType, false>(count);
+
+    for(auto _ : state)
+        for(const auto entity : man->GetAliveEntities())
+            benchmark::DoNotOptimize(man->template HasComponents<Position, Velocity>(entity));
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template<typename ManagerType, bool ThreadSafeComponents>
+static void BM_GetEntityComponents(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto man = MakeWorld<ManagerType, ThreadSafeComponents>(count);
+
+    for(auto _ : state)
+        for(const auto entity : man->GetAliveEntities())
+        {
+            if constexpr(ThreadSafeComponents)
+            {
+                const auto [position, velocity] = std::as_const(*man).template GetEntityComponents<true, Position, Velocity>(entity);
+                benchmark::DoNotOptimize(position.x + velocity.x);
+            }
+            else
+            {
+                auto [position, velocity] = man->template GetEntityComponents<Position, Velocity>(entity);
+                position.x += velocity.x;
+            }
+        }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template<typename ManagerType, bool ThreadSafeComponents>
+static void BM_IterateStorage(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto man = MakeWorld<ManagerType, ThreadSafeComponents>(count);
+
+    for(auto _ : state)
+    {
+        float sum{0.0f};
+        for(const auto& position : std::as_const(*man).template GetComponents<ThreadSafeComponents, Position>())
+            sum += position.x;
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+///Health joining every entity notifies state.range(1) systems interested in it
+template<typename BitsStorageType>
+static void BM_SystemNotificationFanOut(benchmark::State& state)
+{
+    using ManagerType = Manager<BitsStorageType>;
+
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto systemsCount = static_cast<std::size_t>(state.range(1));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto man = MakeWorld<ManagerType, false>(count);
+        for(std::size_t i{0}; i<systemsCount; ++i)
+            man->template CreateSystem<MovementSystem<BitsStorageType>>(MyECS::SystemComponents<Position, Health>{});
+
+        const std::vector<MyECS::Entity> entities(man->GetAliveEntities().begin(), man->GetAliveEntities().end());
+        state.ResumeTiming();
+
+        for(const auto entity : entities)
+            man->template AddComponents<false, Health>(entity, Health{});
+
+        state.PauseTiming();
+        man.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count * systemsCount);
+}
+
+BENCHMARK_TEMPLATE(BM_CreateEntity, Manager<uint8_t>, false, Position)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_CreateEntity, Manager<uint8_t>, false, Position, Velocity, Health)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_CreateEntity, Manager<uint8_t>, true, Position, Velocity, Health)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_CreateEntity, Manager<uint64_t>, false, Position, Velocity, Health)->Apply(EntityCounts);
+
+BENCHMARK_TEMPLATE(BM_AddComponents, Manager<uint8_t>, false)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_AddComponents, Manager<uint8_t>, true)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_AddComponents, Manager<uint64_t>, false)->Apply(EntityCounts);
+
+BENCHMARK_TEMPLATE(BM_DetachComponents, Manager<uint8_t>, false)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_DetachComponents, Manager<uint8_t>, true)->Apply(EntityCounts);
+
+BENCHMARK_TEMPLATE(BM_RemoveEntity, Manager<uint8_t>, false)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_RemoveEntity, Manager<uint8_t>, true)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_RemoveEntity, Manager<uint64_t>, false)->Apply(EntityCounts);
+
+BENCHMARK_TEMPLATE(BM_HasComponents, Manager<uint8_t>)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_HasComponents, Manager<uint16_t>)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_HasComponents, Manager<uint32_t>)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_HasComponents, Manager<uint64_t>)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_HasComponents, Manager<uint64_t, 256>)->Apply(EntityCounts);
+
+BENCHMARK_TEMPLATE(BM_GetEntityComponents, Manager<uint8_t>, false)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_GetEntityComponents, Manager<uint8_t>, true)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_GetEntityComponents, Manager<uint64_t>, false)->Apply(EntityCounts);
+
+BENCHMARK_TEMPLATE(BM_IterateStorage, Manager<uint8_t>, false)->Apply(EntityCounts);
+BENCHMARK_TEMPLATE(BM_IterateStorage, Manager<uint8_t>, true)->Apply(EntityCounts);
+
+BENCHMARK_TEMPLATE(BM_SystemNotificationFanOut, uint8_t)
+    ->ArgsProduct({{1'000, 100'000}, {1, 8, 32}})->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_SystemNotificationFanOut, uint64_t)
+    ->ArgsProduct({{1'000, 100'000}, {1, 8, 32}})->Unit(benchmark::kMicrosecond);
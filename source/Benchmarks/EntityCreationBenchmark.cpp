@@ -0,0 +1,72 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    struct Transform
+    {
+        Transform() { mat4.fill(0.0f); }
+
+        std::array<float, 16> mat4;
+        bool transposed{false};
+    };
+
+    struct Velocity
+    {
+        float x{0.0f}, y{0.0f}, z{0.0f};
+    };
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+}
+
+template<bool ThreadSafeComponents>
+static void BM_CreateEntity(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto man = std::make_unique<Manager>();
+        state.ResumeTiming();
+
+        for(uint32_t i{0}; i<ENTITY_COUNT; ++i)
+            man->CreateEntity<ThreadSafeComponents, Transform, Velocity>({}, {});
+
+        benchmark::DoNotOptimize(man.get());
+
+        state.PauseTiming();
+        man.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+template<bool ThreadSafeComponents>
+static void BM_CreateEntities(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto man = std::make_unique<Manager>();
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(man->CreateEntities<ThreadSafeComponents, Transform, Velocity>(ENTITY_COUNT, [](std::size_t){
+            return std::tuple<Transform, Velocity>{};
+        }));
+
+        state.PauseTiming();
+        man.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+BENCHMARK_TEMPLATE(BM_CreateEntity, false);
+BENCHMARK_TEMPLATE(BM_CreateEntity, true);
+BENCHMARK_TEMPLATE(BM_CreateEntities, false);
+BENCHMARK_TEMPLATE(BM_CreateEntities, true);
@@ -0,0 +1,60 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+struct Position { float x{0.0f}, y{0.0f}, z{0.0f}; };
+struct Velocity { float x{1.0f}, y{1.0f}, z{1.0f}; };
+struct Acceleration { float x{0.5f}, y{0.5f}, z{0.5f}; };
+struct Mass { float value{1.0f}; };
+
+using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+
+static void Populate(Manager& man)
+{
+    // every third entity lacks Acceleration, so storages of the iterated components hold different entities
+    for(uint32_t i{0}; i<ENTITY_COUNT; ++i)
+    {
+        if(i % 3 == 0)
+            man.CreateEntity<false, Position, Velocity, Mass>({}, {}, {});
+        else if(i % 2 == 0)
+            man.CreateEntity<false, Position, Velocity, Acceleration>({}, {}, {});
+        else
+            man.CreateEntity<false, Mass, Acceleration, Velocity, Position>({}, {}, {}, {});
+    }
+}
+
+static void Integrate(MyECS::Entity, Position& position, Velocity& velocity, Acceleration& acceleration)
+{
+    velocity.x += acceleration.x; velocity.y += acceleration.y; velocity.z += acceleration.z;
+    position.x += velocity.x; position.y += velocity.y; position.z += velocity.z;
+}
+
+static void BM_ViewIteration(benchmark::State& state)
+{
+    auto man = std::make_unique<Manager>();
+    Populate(*man);
+
+    for(auto _ : state)
+        for(auto [entity, position, velocity, acceleration] : man->GetView<Position, Velocity, Acceleration>())
+            Integrate(entity, position, velocity, acceleration);
+
+    state.SetItemsProcessed(state.iterations() * man->GetView<Position, Velocity, Acceleration>().Size());
+}
+
+static void BM_GroupIteration(benchmark::State& state)
+{
+    auto man = std::make_unique<Manager>();
+    man->CreateGroup<Position, Velocity, Acceleration>();
+    Populate(*man);
+
+    for(auto _ : state)
+        man->EachInGroup<Position, Velocity, Acceleration>(Integrate);
+
+    state.SetItemsProcessed(state.iterations() * man->GetView<Position, Velocity, Acceleration>().Size());
+}
+
+BENCHMARK(BM_ViewIteration);
+BENCHMARK(BM_GroupIteration);
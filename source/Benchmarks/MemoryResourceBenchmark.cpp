@@ -0,0 +1,68 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+#include <memory_resource>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    ///component owning heap memory, pmr-aware so it allocates from the manager's resource
+    struct Path
+    {
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        explicit Path(allocator_type allocator = {}) : points(20, allocator) {}
+        Path(const Path& other, allocator_type allocator = {}) : points(other.points, allocator) {}
+        Path(Path&& other, allocator_type allocator) : points(std::move(other.points), allocator) {}
+        Path(Path&&) = default;
+        Path& operator=(Path&&) = default;
+
+        std::pmr::vector<int> points;
+    };
+
+    struct Velocity
+    {
+        float x{0.0f}, y{0.0f}, z{0.0f};
+    };
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+
+    void BuildAndTearDownWorld(std::pmr::memory_resource* resource)
+    {
+        auto man = std::make_unique<Manager>(resource);
+
+        for(uint32_t i{0}; i<ENTITY_COUNT; ++i)
+            man->EmplaceComponent<false, Path>(man->CreateEntity<false, Velocity>({}));
+
+        benchmark::DoNotOptimize(man.get());
+    }
+}
+
+///world of ENTITY_COUNT entities is built and destroyed every iteration
+static void BM_WorldDefaultResource(benchmark::State& state)
+{
+    for(auto _ : state)
+        BuildAndTearDownWorld(std::pmr::get_default_resource());
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+///same world backed by a monotonic arena, its memory is released at once when the arena goes away
+static void BM_WorldMonotonicArena(benchmark::State& state)
+{
+    std::vector<std::byte> buffer(64 * 1024 * 1024);
+
+    for(auto _ : state)
+    {
+        std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size()};
+        BuildAndTearDownWorld(&arena);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+BENCHMARK(BM_WorldDefaultResource)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_WorldMonotonicArena)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,48 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    struct Health
+    {
+        int value{100};
+    };
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+}
+
+///adds and detaches Health on every entity and dispatches the frame's events, state.range(0) is count of
+///observers listening to both add and remove of Health (0 shows the cost of the hooks alone)
+static void BM_ObservedAddDetach(benchmark::State& state)
+{
+    auto man = std::make_unique<Manager>();
+    const auto entities = man->CreateEntities<false, int>(ENTITY_COUNT, [](std::size_t i){
+        return std::tuple<int>{static_cast<int>(i)};
+    });
+
+    std::size_t delivered{0};
+    for(int64_t i{0}; i<state.range(0); ++i)
+    {
+        man->OnAdd<Health>([&delivered](std::span<const MyECS::Entity> batch){ delivered += batch.size(); });
+        man->OnRemove<Health>([&delivered](std::span<const MyECS::Entity> batch){ delivered += batch.size(); });
+    }
+
+    for(auto _ : state)
+    {
+        for(const auto entity : entities)
+            man->AddComponents<false, Health>(entity, Health{});
+        for(const auto entity : entities)
+            man->DetachComponents<Health>(entity);
+
+        man->DispatchObservers();
+    }
+
+    benchmark::DoNotOptimize(delivered);
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT * 2);
+}
+
+BENCHMARK(BM_ObservedAddDetach)->Arg(0)->Arg(1)->Arg(8)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,72 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    struct Matrix
+    {
+        Matrix() { mat4.fill(1.0f); }
+
+        std::array<float, 16> mat4;
+        bool transposed{false};
+    };
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+
+    std::unique_ptr<Manager> MakeManager()
+    {
+        auto man = std::make_unique<Manager>();
+        for(uint32_t i{0}; i<ENTITY_COUNT; ++i)
+            man->CreateEntity<false, Matrix>({});
+
+        return man;
+    }
+
+    void Scale(Matrix& matrix)
+    {
+        for(auto& value : matrix.mat4)
+            value *= 1.0001f;
+    }
+}
+
+static void BM_SerialComponentsLoop(benchmark::State& state)
+{
+    auto man = MakeManager();
+
+    for(auto _ : state)
+        for(auto& matrix : man->GetComponents<Matrix>())
+            Scale(matrix);
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+static void BM_ParallelEachPerComponent(benchmark::State& state)
+{
+    auto man = MakeManager();
+
+    for(auto _ : state)
+        man->ParallelEach<Matrix>([](MyECS::Entity, Matrix& matrix){ Scale(matrix); }, state.range(0));
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+static void BM_ParallelEachSpan(benchmark::State& state)
+{
+    auto man = MakeManager();
+
+    for(auto _ : state)
+        man->ParallelEach<Matrix>([](std::span<const MyECS::Entity>, std::span<Matrix> matrices){
+            for(auto& matrix : matrices)
+                Scale(matrix);
+        }, state.range(0));
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+BENCHMARK(BM_SerialComponentsLoop);
+BENCHMARK(BM_ParallelEachPerComponent)->Arg(0)->Arg(1024)->Arg(8192)->UseRealTime();
+BENCHMARK(BM_ParallelEachSpan)->Arg(0)->Arg(1024)->Arg(8192)->UseRealTime();
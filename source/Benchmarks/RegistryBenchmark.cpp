@@ -0,0 +1,88 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    struct Transform
+    {
+        Transform() { mat4.fill(0.0f); }
+
+        std::array<float, 16> mat4;
+        bool transposed{false};
+    };
+
+    struct Velocity
+    {
+        float x{0.0f}, y{0.0f}, z{0.0f};
+    };
+
+    struct Health
+    {
+        int value{100};
+    };
+
+    using RuntimeManager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+    using RegistryManager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType,
+                                                 MyECS::Registry<Transform, Velocity, Health>>;
+
+    ///every other entity has Health
+    template<typename Manager>
+    std::unique_ptr<Manager> MakeManager()
+    {
+        auto man = std::make_unique<Manager>();
+        const auto entities = man->template CreateEntities<false, Transform, Velocity>(ENTITY_COUNT, [](std::size_t){
+            return std::tuple<Transform, Velocity>{};
+        });
+
+        for(std::size_t i{0}; i<entities.size(); i += 2)
+            man->template AddComponents<false, Health>(entities[i], {});
+
+        return man;
+    }
+}
+
+template<typename Manager>
+static void BM_HasComponents(benchmark::State& state)
+{
+    const auto man = MakeManager<Manager>();
+
+    for(auto _ : state)
+    {
+        std::size_t count{0};
+        for(const auto entity : man->GetAliveEntities())
+            count += man->template HasComponents<Transform, Velocity, Health>(entity);
+
+        benchmark::DoNotOptimize(count);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+template<typename Manager>
+static void BM_GetEntityComponents(benchmark::State& state)
+{
+    const auto man = MakeManager<Manager>();
+
+    for(auto _ : state)
+    {
+        float sum{0.0f};
+        for(const auto entity : man->GetAliveEntities())
+        {
+            auto [transform, velocity] = man->template GetEntityComponents<Transform, Velocity>(entity);
+            sum += transform.mat4[0] + velocity.x;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+BENCHMARK_TEMPLATE(BM_HasComponents, RuntimeManager);
+BENCHMARK_TEMPLATE(BM_HasComponents, RegistryManager);
+BENCHMARK_TEMPLATE(BM_GetEntityComponents, RuntimeManager);
+BENCHMARK_TEMPLATE(BM_GetEntityComponents, RegistryManager);
@@ -0,0 +1,75 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    struct Transform
+    {
+        Transform() { mat4.fill(0.0f); }
+
+        std::array<float, 16> mat4;
+        bool transposed{false};
+    };
+
+    struct Velocity
+    {
+        float x{0.0f}, y{0.0f}, z{0.0f};
+    };
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+
+    std::unique_ptr<Manager> MakeWorld()
+    {
+        auto man = std::make_unique<Manager>();
+        for(uint32_t i{0}; i<ENTITY_COUNT; ++i)
+            man->CreateEntity<false, Transform, Velocity>({}, {});
+
+        return man;
+    }
+}
+
+///rebuilding the world entity by entity, what restoring took without snapshots
+static void BM_RebuildWorld(benchmark::State& state)
+{
+    for(auto _ : state)
+        benchmark::DoNotOptimize(MakeWorld());
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+static void BM_SaveSnapshot(benchmark::State& state)
+{
+    const auto man = MakeWorld();
+    std::vector<std::byte> snapshot;
+
+    for(auto _ : state)
+    {
+        man->SaveSnapshot(snapshot);
+        benchmark::DoNotOptimize(snapshot.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+    state.SetBytesProcessed(state.iterations() * snapshot.size());
+}
+
+///world restored over itself (rollback)
+static void BM_LoadSnapshot(benchmark::State& state)
+{
+    const auto man = MakeWorld();
+    std::vector<std::byte> snapshot;
+    man->SaveSnapshot(snapshot);
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(man->LoadSnapshot(snapshot));
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+    state.SetBytesProcessed(state.iterations() * snapshot.size());
+}
+
+BENCHMARK(BM_RebuildWorld)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SaveSnapshot)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadSnapshot)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,147 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    ///same component twice, RigidBody in array of structs, SoARigidBody in structure of arrays
+    struct RigidBody
+    {
+        float px{0.0f}, py{0.0f}, pz{0.0f};
+        float vx{1.0f}, vy{1.0f}, vz{1.0f};
+        float mass{1.0f};
+        bool sleeping{false};
+    };
+
+    struct SoARigidBody : RigidBody {};
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+
+    template<typename T>
+    std::unique_ptr<Manager> MakeWorld()
+    {
+        auto man = std::make_unique<Manager>();
+        man->CreateEntities<false, T>(ENTITY_COUNT, [](std::size_t){ return std::tuple<T>{}; });
+
+        return man;
+    }
+
+    constexpr float dt{1.0f / 60.0f};
+}
+
+template<>
+struct MyECS::SoAFields<SoARigidBody>
+{
+    static constexpr auto Members = std::make_tuple(&SoARigidBody::px, &SoARigidBody::py, &SoARigidBody::pz,
+                                                    &SoARigidBody::vx, &SoARigidBody::vy, &SoARigidBody::vz,
+                                                    &SoARigidBody::mass, &SoARigidBody::sleeping);
+};
+
+///integrates positions, loads whole bodies to use 6 of their floats
+static void BM_IntegrateAoS(benchmark::State& state)
+{
+    const auto man = MakeWorld<RigidBody>();
+    auto& bodies = man->GetComponents<RigidBody>();
+
+    for(auto _ : state)
+    {
+        for(auto& body : bodies)
+        {
+            body.px += body.vx * dt;
+            body.py += body.vy * dt;
+            body.pz += body.vz * dt;
+        }
+        benchmark::DoNotOptimize(bodies.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+///same integration over member arrays, loops vectorize
+static void BM_IntegrateSoA(benchmark::State& state)
+{
+    const auto man = MakeWorld<SoARigidBody>();
+    auto& bodies = man->GetComponents<SoARigidBody>();
+
+    for(auto _ : state)
+    {
+        const auto integrate = [](std::span<float> position, std::span<const float> velocity){
+            for(std::size_t i{0}; i<position.size(); ++i)
+                position[i] += velocity[i] * dt;
+        };
+        integrate(bodies.Field<&SoARigidBody::px>(), bodies.Field<&SoARigidBody::vx>());
+        integrate(bodies.Field<&SoARigidBody::py>(), bodies.Field<&SoARigidBody::vy>());
+        integrate(bodies.Field<&SoARigidBody::pz>(), bodies.Field<&SoARigidBody::vz>());
+        benchmark::DoNotOptimize(bodies.Field<&SoARigidBody::px>().data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+///reads a single member of every body
+static void BM_SumMassAoS(benchmark::State& state)
+{
+    const auto man = MakeWorld<RigidBody>();
+    const auto& bodies = man->GetComponents<RigidBody>();
+
+    for(auto _ : state)
+    {
+        float mass{0.0f};
+        for(const auto& body : bodies)
+            mass += body.mass;
+        benchmark::DoNotOptimize(mass);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+static void BM_SumMassSoA(benchmark::State& state)
+{
+    const auto man = MakeWorld<SoARigidBody>();
+    const auto& bodies = man->GetComponents<SoARigidBody>();
+
+    for(auto _ : state)
+    {
+        float mass{0.0f};
+        for(const auto m : bodies.Field<&SoARigidBody::mass>())
+            mass += m;
+        benchmark::DoNotOptimize(mass);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+///per entity access through proxies costs a gather/scatter
+static void BM_EntityAccessAoS(benchmark::State& state)
+{
+    const auto man = MakeWorld<RigidBody>();
+    const auto entities = man->GetAliveEntities();
+
+    for(auto _ : state)
+        for(const auto entity : entities)
+            std::get<0>(man->GetEntityComponents<RigidBody>(entity)).px += dt;
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+static void BM_EntityAccessSoA(benchmark::State& state)
+{
+    const auto man = MakeWorld<SoARigidBody>();
+    const auto entities = man->GetAliveEntities();
+
+    for(auto _ : state)
+        for(const auto entity : entities)
+            std::get<0>(man->GetEntityComponents<SoARigidBody>(entity)).Get<&SoARigidBody::px>() += dt;
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+BENCHMARK(BM_IntegrateAoS)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_IntegrateSoA)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SumMassAoS)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SumMassSoA)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EntityAccessAoS)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EntityAccessSoA)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,128 @@
+#include <Inc/ComponentStorage.h>
+#include <benchmark/benchmark.h>
+
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+struct Transform
+{
+    Transform() { mat4.fill(0.0f); }
+
+    std::array<float, 16> mat4;
+    bool transposed{false};
+};
+
+///previous storage backend (two hash maps kept in step with the dense array),
+///kept here only as a reference point for the sparse set backend
+template<typename T>
+struct HashMapStorage
+{
+    void AddComponentInstance(MyECS::Entity entity, T&& instance)
+    {
+        _entityToComponentIndex[entity] = _componentInstances.size();
+        _componentIndexToEntity[_componentInstances.size()] = entity;
+        _componentInstances.emplace_back(instance);
+    }
+
+    void DeleteComponentInstance(MyECS::Entity entity)
+    {
+        _componentInstances[_entityToComponentIndex[entity]] = std::move(_componentInstances.back());
+
+        _entityToComponentIndex[_componentIndexToEntity[_componentInstances.size() - 1]] = _entityToComponentIndex[entity];
+        _componentIndexToEntity[_entityToComponentIndex[entity]] = _componentIndexToEntity[_componentInstances.size() - 1];
+
+        _entityToComponentIndex.erase(entity);
+        _componentIndexToEntity.erase(_componentInstances.size() - 1);
+
+        _componentInstances.pop_back();
+    }
+
+    T& GetByEntity(MyECS::Entity entity) { return _componentInstances[_entityToComponentIndex.at(entity)]; }
+
+    std::unordered_map<MyECS::Entity, std::size_t> _entityToComponentIndex;
+    std::unordered_map<std::size_t, MyECS::Entity> _componentIndexToEntity;
+    std::vector<T> _componentInstances;
+};
+
+template<bool ThreadSafeStorage>
+using SparseSetStorage = MyECS::ComponentsStorage<COMPONENTS_COUNT, BitsStorageType, Transform, ThreadSafeStorage>;
+
+static std::vector<MyECS::Entity> ShuffledEntities()
+{
+    std::vector<MyECS::Entity> entities(ENTITY_COUNT);
+    std::iota(entities.begin(), entities.end(), 0);
+    std::shuffle(entities.begin(), entities.end(), std::mt19937{42});
+
+    return entities;
+}
+
+template<typename Storage>
+static void BM_AddComponentInstance(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        Storage storage;
+        for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; ++entity)
+            storage.AddComponentInstance(entity, Transform{});
+
+        benchmark::DoNotOptimize(storage);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+template<typename Storage>
+static void BM_GetByEntity(benchmark::State& state)
+{
+    Storage storage;
+    for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; ++entity)
+        storage.AddComponentInstance(entity, Transform{});
+
+    const auto entities = ShuffledEntities();
+
+    for(auto _ : state)
+        for(const auto entity : entities)
+            benchmark::DoNotOptimize(storage.GetByEntity(entity));
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+template<typename Storage>
+static void BM_DeleteComponentInstance(benchmark::State& state)
+{
+    const auto entities = ShuffledEntities();
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        Storage storage;
+        for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; ++entity)
+            storage.AddComponentInstance(entity, Transform{});
+        state.ResumeTiming();
+
+        for(const auto entity : entities)
+            storage.DeleteComponentInstance(entity);
+
+        benchmark::DoNotOptimize(storage);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+
+BENCHMARK_TEMPLATE(BM_AddComponentInstance, HashMapStorage<Transform>);
+BENCHMARK_TEMPLATE(BM_AddComponentInstance, SparseSetStorage<false>);
+BENCHMARK_TEMPLATE(BM_AddComponentInstance, SparseSetStorage<true>);
+
+BENCHMARK_TEMPLATE(BM_GetByEntity, HashMapStorage<Transform>);
+BENCHMARK_TEMPLATE(BM_GetByEntity, SparseSetStorage<false>);
+BENCHMARK_TEMPLATE(BM_GetByEntity, SparseSetStorage<true>);
+
+BENCHMARK_TEMPLATE(BM_DeleteComponentInstance, HashMapStorage<Transform>);
+BENCHMARK_TEMPLATE(BM_DeleteComponentInstance, SparseSetStorage<false>);
+BENCHMARK_TEMPLATE(BM_DeleteComponentInstance, SparseSetStorage<true>);
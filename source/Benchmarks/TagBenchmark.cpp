@@ -0,0 +1,69 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    ///empty, lives only in the entity's components bits
+    struct Stunned {};
+
+    ///the same marker with a byte of state, kept in a storage
+    struct StunnedFlag
+    {
+        bool value{true};
+    };
+
+    struct Settings
+    {
+        float gravity{9.81f};
+    };
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+}
+
+///adds and detaches marker T on every entity, state machine style
+template<typename T>
+static void BM_MarkerFlip(benchmark::State& state)
+{
+    auto man = std::make_unique<Manager>();
+    const auto entities = man->CreateEntities<false, int>(ENTITY_COUNT, [](std::size_t i){
+        return std::tuple<int>{static_cast<int>(i)};
+    });
+
+    for(auto _ : state)
+    {
+        for(const auto entity : entities)
+            man->AddComponents<false, T>(entity, T{});
+        for(const auto entity : entities)
+            man->DetachComponents<T>(entity);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT * 2);
+}
+
+static void BM_SingletonAccess(benchmark::State& state)
+{
+    auto man = std::make_unique<Manager>();
+    man->SetSingleton<Settings>();
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(man->GetSingleton<Settings>().gravity);
+}
+
+///the same settings kept as component of a dedicated entity
+static void BM_SingletonEntityAccess(benchmark::State& state)
+{
+    auto man = std::make_unique<Manager>();
+    const auto entity = man->CreateEntity<false, Settings>(Settings{});
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(std::get<0>(std::as_const(*man).GetEntityComponents<false, Settings>(entity)).gravity);
+}
+
+BENCHMARK_TEMPLATE(BM_MarkerFlip, Stunned)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MarkerFlip, StunnedFlag)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SingletonAccess);
+BENCHMARK(BM_SingletonEntityAccess);
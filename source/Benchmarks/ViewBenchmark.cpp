@@ -0,0 +1,79 @@
+#include <Inc/EntityManager.h>
+#include <benchmark/benchmark.h>
+
+#define ENTITY_COUNT 65536
+#define COMPONENTS_COUNT 16
+using BitsStorageType = uint8_t;
+
+namespace
+{
+    struct Position { float x{0.0f}, y{0.0f}, z{0.0f}; };
+    struct Velocity { float x{1.0f}, y{1.0f}, z{1.0f}; };
+    struct Acceleration { float x{0.5f}, y{0.5f}, z{0.5f}; };
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+
+    std::unique_ptr<Manager> MakeManager()
+    {
+        auto man = std::make_unique<Manager>();
+        for(uint32_t i{0}; i<ENTITY_COUNT; ++i)
+        {
+            if(i % 2 == 0)
+                man->CreateEntity<false, Position, Velocity, Acceleration>({}, {}, {});
+            else
+                man->CreateEntity<false, Position, Velocity>({}, {});
+        }
+
+        return man;
+    }
+
+    void Integrate(Position& position, Velocity& velocity, const Acceleration& acceleration)
+    {
+        velocity.x += acceleration.x; velocity.y += acceleration.y; velocity.z += acceleration.z;
+        position.x += velocity.x; position.y += velocity.y; position.z += velocity.z;
+    }
+}
+
+static void BM_HasComponentsLoop(benchmark::State& state)
+{
+    auto man = MakeManager();
+
+    for(auto _ : state)
+        for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; ++entity)
+            if(man->HasComponents<Position, Velocity, Acceleration>(entity))
+            {
+                auto [position, velocity, acceleration] = man->GetEntityComponents<Position, Velocity, Acceleration>(entity);
+                Integrate(position, velocity, acceleration);
+            }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT / 2);
+}
+
+static void BM_ViewRangeFor(benchmark::State& state)
+{
+    auto man = MakeManager();
+    auto view = man->GetView<Position, Velocity, Acceleration>();
+
+    for(auto _ : state)
+        for(auto [entity, position, velocity, acceleration] : view)
+            Integrate(position, velocity, acceleration);
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT / 2);
+}
+
+static void BM_ViewParallelEach(benchmark::State& state)
+{
+    auto man = MakeManager();
+    auto view = man->GetView<Position, Velocity, Acceleration>();
+
+    for(auto _ : state)
+        view.Each(std::execution::par_unseq, [](MyECS::Entity, Position& position, Velocity& velocity, Acceleration& acceleration){
+            Integrate(position, velocity, acceleration);
+        });
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT / 2);
+}
+
+BENCHMARK(BM_HasComponentsLoop);
+BENCHMARK(BM_ViewRangeFor);
+BENCHMARK(BM_ViewParallelEach)->UseRealTime();
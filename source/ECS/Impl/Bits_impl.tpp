@@ -5,6 +5,44 @@
 
 namespace MyECS
 {
+    namespace Detail
+    {
+        template<std::size_t size>
+        struct BitsVector;
+
+    #ifdef __AVX2__
+        template<>
+        struct BitsVector<32>
+        {
+            using Type = __m256i;
+
+            static Type Load(const void* data) { return _mm256_loadu_si256(static_cast<const __m256i*>(data)); }
+            static void Store(void* data, Type value) { _mm256_storeu_si256(static_cast<__m256i*>(data), value); }
+            static Type Or(Type lhs, Type rhs) { return _mm256_or_si256(lhs, rhs); }
+            static Type And(Type lhs, Type rhs) { return _mm256_and_si256(lhs, rhs); }
+            ///~lhs & rhs
+            static Type AndNot(Type lhs, Type rhs) { return _mm256_andnot_si256(lhs, rhs); }
+            static bool IsZero(Type value) { return _mm256_testz_si256(value, value); }
+        };
+    #endif
+
+    #ifdef __SSE2__
+        template<>
+        struct BitsVector<16>
+        {
+            using Type = __m128i;
+
+            static Type Load(const void* data) { return _mm_loadu_si128(static_cast<const __m128i*>(data)); }
+            static void Store(void* data, Type value) { _mm_storeu_si128(static_cast<__m128i*>(data), value); }
+            static Type Or(Type lhs, Type rhs) { return _mm_or_si128(lhs, rhs); }
+            static Type And(Type lhs, Type rhs) { return _mm_and_si128(lhs, rhs); }
+            ///~lhs & rhs
+            static Type AndNot(Type lhs, Type rhs) { return _mm_andnot_si128(lhs, rhs); }
+            static bool IsZero(Type value) { return _mm_movemask_epi8(_mm_cmpeq_epi8(value, _mm_setzero_si128())) == 0xFFFF; }
+        };
+    #endif
+    }
+
     template<typename T, std::size_t count> requires std::is_unsigned_v<T>
     void Bits<T, count>::TrySet(size_t bitIndex)
     {
@@ -21,7 +59,7 @@ namespace MyECS
 
 
     template<typename T, std::size_t count> requires std::is_unsigned_v<T>
-    void Bits<T, count>::Set(size_t bitIndex)
+    constexpr void Bits<T, count>::Set(size_t bitIndex)
     {
         _bits[bitIndex >> _divideShift] |= _setMask << (bitIndex & _moduloMask);
     }
@@ -49,35 +87,72 @@ namespace MyECS
     }
 
     template<typename T, std::size_t count> requires std::is_unsigned_v<T>
-    template<typename size_type, size_type... Indices>
-    void Bits<T, count>::GetSetBitsOnType(std::integer_sequence<size_type, Indices...>,
-            T varFromBitset, std::vector<uint32_t> &result, uint32_t offset) const
+    Bits<T, count>::OnesIterator::OnesIterator(const T* words, std::size_t wordIndex)
+        : _words(words), _wordIndex(wordIndex)
     {
-        static auto checkIfWrapper_fn = [&result](size_type index, T varFromBitset){
-            if(varFromBitset & (Bits<T,count>::_setMask << index))
-                result.push_back(index);
-        };
-
-        (checkIfWrapper_fn(Indices + offset, varFromBitset), ...);
+        SkipZeroWords();
     }
 
     template<typename T, std::size_t count> requires std::is_unsigned_v<T>
-    std::vector<uint32_t> Bits<T, count>::GetOnes() const
+    typename Bits<T, count>::OnesIterator& Bits<T, count>::OnesIterator::operator++()
     {
-        std::vector<uint32_t> result;
-        result.reserve(_bits.size()/2);
+        _word = static_cast<T>(_word & (_word - 1));
+        if(_word == 0)
+        {
+            ++_wordIndex;
+            SkipZeroWords();
+        }
 
-        for(std::size_t i{0}; i<_bits.size(); ++i)
-            GetSetBitsOnType(_compiledSequence, _bits[i], result, i);
+        return *this;
+    }
 
-        return result;
+    template<typename T, std::size_t count> requires std::is_unsigned_v<T>
+    void Bits<T, count>::OnesIterator::SkipZeroWords()
+    {
+        static constexpr std::size_t wordsPerChunk = sizeof(uint64_t) / sizeof(T);
+
+        // bounds are compared against constants only, so the index can't wrap around and read past the words
+        if constexpr(wordsPerChunk > 1 && _trueCount >= wordsPerChunk)
+        {
+            for(uint64_t chunk; _wordIndex <= _trueCount - wordsPerChunk; _wordIndex += wordsPerChunk)
+            {
+                std::memcpy(&chunk, _words + _wordIndex, sizeof(chunk));
+                if(chunk != 0) break;
+            }
+        }
+
+        for(; _wordIndex < _trueCount; ++_wordIndex)
+        {
+            _word = _words[_wordIndex];
+            if(_word != 0) return;
+        }
+
+        _word = 0;
+    }
+
+    template<typename T, std::size_t count> requires std::is_unsigned_v<T>
+    typename Bits<T, count>::OnesRange Bits<T, count>::Ones() const
+    {
+        return {OnesIterator{_bits.data(), 0}, OnesIterator{_bits.data(), _trueCount}};
     }
 
     template<typename T, std::size_t count> requires std::is_unsigned_v<T>
     Bits<T, count>& Bits<T, count>::operator|=(const Bits<T, count>& other)
     {
-        for(std::size_t i{0}; i<_bits.size(); ++i)
-            _bits[i] |= other._bits[i];
+        if constexpr(_vectorSize != 0)
+        {
+            using Vector = Detail::BitsVector<_vectorSize>;
+            auto* lhs = reinterpret_cast<std::byte*>(_bits.data());
+            const auto* rhs = reinterpret_cast<const std::byte*>(other._bits.data());
+
+            for(std::size_t offset{0}; offset<_bytesCount; offset += _vectorSize)
+                Vector::Store(lhs + offset, Vector::Or(Vector::Load(lhs + offset), Vector::Load(rhs + offset)));
+        }
+        else
+        {
+            for(std::size_t i{0}; i<_bits.size(); ++i)
+                _bits[i] |= other._bits[i];
+        }
 
         return *this;
     }
@@ -85,8 +160,20 @@ namespace MyECS
     template<typename T, std::size_t count> requires std::is_unsigned_v<T>
     Bits<T, count>& Bits<T, count>::operator&=(const Bits<T, count>& other)
     {
-        for(std::size_t i{0}; i<_bits.size(); ++i)
-            _bits[i] &= other._bits[i];
+        if constexpr(_vectorSize != 0)
+        {
+            using Vector = Detail::BitsVector<_vectorSize>;
+            auto* lhs = reinterpret_cast<std::byte*>(_bits.data());
+            const auto* rhs = reinterpret_cast<const std::byte*>(other._bits.data());
+
+            for(std::size_t offset{0}; offset<_bytesCount; offset += _vectorSize)
+                Vector::Store(lhs + offset, Vector::And(Vector::Load(lhs + offset), Vector::Load(rhs + offset)));
+        }
+        else
+        {
+            for(std::size_t i{0}; i<_bits.size(); ++i)
+                _bits[i] &= other._bits[i];
+        }
 
         return *this;
     }
@@ -100,8 +187,20 @@ namespace MyECS
     template<typename T, std::size_t count> requires std::is_unsigned_v<T>
     bool Bits<T, count>::IsAndNonZero(const Bits<T, count>& other) const
     {
-        for(std::size_t i{0}; i<_bits.size(); ++i)
-            if(_bits[i] & other._bits[i]) return true;
+        if constexpr(_vectorSize != 0)
+        {
+            using Vector = Detail::BitsVector<_vectorSize>;
+            const auto* lhs = reinterpret_cast<const std::byte*>(_bits.data());
+            const auto* rhs = reinterpret_cast<const std::byte*>(other._bits.data());
+
+            for(std::size_t offset{0}; offset<_bytesCount; offset += _vectorSize)
+                if(!Vector::IsZero(Vector::And(Vector::Load(lhs + offset), Vector::Load(rhs + offset)))) return true;
+        }
+        else
+        {
+            for(std::size_t i{0}; i<_bits.size(); ++i)
+                if(_bits[i] & other._bits[i]) return true;
+        }
 
         return false;
     }
@@ -109,8 +208,21 @@ namespace MyECS
     template<typename T, std::size_t count> requires std::is_unsigned_v<T>
     bool Bits<T, count>::DoesAndEqualThis(const Bits <T, count> &other) const
     {
-        for(std::size_t i{0}; i<_bits.size(); ++i)
-            if((_bits[i] & other._bits[i]) != _bits[i]) return false;
+        // (this & other) == this holds when no bit of this is missing in other
+        if constexpr(_vectorSize != 0)
+        {
+            using Vector = Detail::BitsVector<_vectorSize>;
+            const auto* lhs = reinterpret_cast<const std::byte*>(_bits.data());
+            const auto* rhs = reinterpret_cast<const std::byte*>(other._bits.data());
+
+            for(std::size_t offset{0}; offset<_bytesCount; offset += _vectorSize)
+                if(!Vector::IsZero(Vector::AndNot(Vector::Load(rhs + offset), Vector::Load(lhs + offset)))) return false;
+        }
+        else
+        {
+            for(std::size_t i{0}; i<_bits.size(); ++i)
+                if((_bits[i] & other._bits[i]) != _bits[i]) return false;
+        }
 
         return true;
     }
@@ -0,0 +1,81 @@
+#include "ChangeTracker.h"
+using namespace MyECS;
+
+void ChangeTracker::Enable(const ChangeTick* clock, std::size_t size)
+{
+    _clock = clock;
+    Reset(size);
+}
+
+void ChangeTracker::OnAdd(std::size_t count)
+{
+    const std::size_t first = _ticks.size();
+    _ticks.resize(first + count, *_clock);
+
+    // partially filled last block gets the new tick, new blocks start with it
+    if(count != 0 && first % _blockSize != 0)
+        _blockTicks[first / _blockSize] = *_clock;
+
+    _blockTicks.resize((_ticks.size() + _blockSize - 1) / _blockSize, *_clock);
+}
+
+void ChangeTracker::OnErase(std::size_t denseIndex, Entity entity)
+{
+    _removals.emplace_back(entity, *_clock);
+
+    // moved slot keeps its tick, block maxima only ever grow so they stay an upper bound
+    _ticks[denseIndex] = _ticks.back();
+    _blockTicks[denseIndex / _blockSize] = std::max(_blockTicks[denseIndex / _blockSize], _ticks.back());
+    _ticks.pop_back();
+
+    _blockTicks.resize((_ticks.size() + _blockSize - 1) / _blockSize);
+}
+
+void ChangeTracker::MarkAll()
+{
+    std::fill(_ticks.begin(), _ticks.end(), *_clock);
+    std::fill(_blockTicks.begin(), _blockTicks.end(), *_clock);
+}
+
+void ChangeTracker::Swap(std::size_t lhs, std::size_t rhs)
+{
+    std::swap(_ticks[lhs], _ticks[rhs]);
+    _blockTicks[lhs / _blockSize] = std::max(_blockTicks[lhs / _blockSize], _ticks[lhs]);
+    _blockTicks[rhs / _blockSize] = std::max(_blockTicks[rhs / _blockSize], _ticks[rhs]);
+}
+
+void ChangeTracker::ShrinkToFit()
+{
+    _ticks.shrink_to_fit();
+    _blockTicks.shrink_to_fit();
+    _removals.shrink_to_fit();
+}
+
+void ChangeTracker::Reset(std::size_t size)
+{
+    _ticks.assign(size, *_clock);
+    _blockTicks.assign((size + _blockSize - 1) / _blockSize, *_clock);
+}
+
+void ChangeTracker::Collect(ChangeTick since, std::span<const Entity> entities, uint32_t componentId, ChangeSet& changes) const
+{
+    for(std::size_t block{0}; block<_blockTicks.size(); ++block)
+    {
+        if(_blockTicks[block] <= since)
+            continue;
+
+        const std::size_t end = std::min((block + 1) * _blockSize, _ticks.size());
+        for(std::size_t i{block * _blockSize}; i<end; ++i)
+            if(_ticks[i] > since)
+                changes.changed.push_back({entities[i], componentId});
+    }
+
+    for(const auto& [entity, tick] : _removals)
+        if(tick > since)
+            changes.removed.push_back({entity, componentId});
+}
+
+void ChangeTracker::DiscardRemovals(ChangeTick until)
+{
+    std::erase_if(_removals, [until](const auto& removal){ return removal.second <= until; });
+}
@@ -0,0 +1,162 @@
+#ifndef MYECS_COMMANDBUFFER_IMPL_TPP
+#define MYECS_COMMANDBUFFER_IMPL_TPP
+
+#include <Inc/CommandBuffer.h>
+#include <new>
+
+namespace MyECS
+{
+    template<typename Manager>
+    CommandBuffer<Manager>::~CommandBuffer()
+    {
+        Clear();
+    }
+
+    template<typename Manager>
+    template<bool ThreadSafeComponents, typename... Args>
+    Entity CommandBuffer<Manager>::CreateEntity(Args&&... components)
+    {
+        const Entity entity = ProvisionalEntityFlag | _provisionalCount++;
+        Record(CommandType::Create, entity, nullptr, nullptr, 0, 1);
+
+        if constexpr(sizeof...(Args) > 0)
+            AddComponents<ThreadSafeComponents>(entity, std::forward<Args>(components)...);
+
+        return entity;
+    }
+
+    template<typename Manager>
+    template<bool ThreadSafeComponents, typename... Args>
+    void CommandBuffer<Manager>::AddComponents(Entity entity, Args&&... components)
+    {
+        using Payload = std::tuple<std::decay_t<Args>...>;
+        static_assert(alignof(Payload) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned components can't be recorded");
+
+        // entity may have got the component from other buffer after recording, then the last flushed value wins
+        static constexpr auto apply = [](Manager& manager, Entity target, std::byte* payload){
+            std::apply([&manager, target](auto&... component){
+                ((manager.template HasComponent<std::decay_t<decltype(component)>>(target)
+                    ? manager.template AssignComponent<ThreadSafeComponents>(target, std::move(component))
+                    : manager.template AttachComponents<ThreadSafeComponents>(target, std::move(component))), ...);
+            }, *std::launder(reinterpret_cast<Payload*>(payload)));
+        };
+
+        static constexpr auto destroy = [](std::byte* payload){
+            std::launder(reinterpret_cast<Payload*>(payload))->~Payload();
+        };
+
+        auto* payload = Record(CommandType::Modify, entity, apply,
+                               std::is_trivially_destructible_v<Payload> ? nullptr : +destroy,
+                               sizeof(Payload), alignof(Payload));
+
+        new(payload) Payload(std::forward<Args>(components)...);
+    }
+
+    template<typename Manager>
+    template<typename... Args>
+    void CommandBuffer<Manager>::DetachComponents(Entity entity)
+    {
+        // components detached by other buffer in the meantime are skipped
+        static constexpr auto apply = [](Manager& manager, Entity target, std::byte*){
+            ((manager.template HasComponent<Args>(target) ? manager.template DetachComponent<Args>(target) : void()), ...);
+        };
+
+        Record(CommandType::Modify, entity, apply, nullptr, 0, 1);
+    }
+
+    template<typename Manager>
+    void CommandBuffer<Manager>::RemoveEntity(Entity entity)
+    {
+        static constexpr auto apply = [](Manager& manager, Entity target, std::byte*){
+            manager.RemoveEntity(target);
+        };
+
+        Record(CommandType::Remove, entity, apply, nullptr, 0, 1);
+    }
+
+    template<typename Manager>
+    void CommandBuffer<Manager>::Clear()
+    {
+        ForEachCommand([](Command& command, std::byte* payload){
+            if(command.destroy)
+                command.destroy(payload);
+        });
+
+        for(auto& block : _blocks)
+            block.used = 0;
+
+        _currentBlock = 0;
+        _commandsCount = 0;
+        _provisionalCount = 0;
+    }
+
+    template<typename Manager>
+    std::byte* CommandBuffer<Manager>::Record(CommandType type, Entity entity, void(*apply)(Manager&, Entity, std::byte*),
+                                              void(*destroy)(std::byte*), std::size_t payloadSize, std::size_t payloadAlignment)
+    {
+        static constexpr auto alignUp = [](std::size_t value, std::size_t alignment){
+            return (value + alignment - 1) & ~(alignment - 1);
+        };
+
+        const auto layout = [&](std::size_t offset, std::size_t& commandOffset, std::size_t& payloadOffset){
+            commandOffset = alignUp(offset, alignof(Command));
+            payloadOffset = alignUp(commandOffset + sizeof(Command), payloadAlignment);
+            return payloadOffset + payloadSize;
+        };
+
+        std::size_t commandOffset, payloadOffset;
+
+        if(_blocks.empty() || layout(_blocks[_currentBlock].used, commandOffset, payloadOffset) > _blocks[_currentBlock].capacity)
+        {
+            const std::size_t required = layout(0, commandOffset, payloadOffset);
+
+            if(!_blocks.empty() && _blocks[_currentBlock].used > 0)
+                ++_currentBlock;
+
+            while(_currentBlock < _blocks.size() && _blocks[_currentBlock].capacity < required)
+                ++_currentBlock;
+
+            if(_currentBlock == _blocks.size())
+            {
+                const std::size_t capacity = std::max(_blockSize, required);
+                _blocks.push_back({std::make_unique<std::byte[]>(capacity), capacity, 0});
+            }
+        }
+
+        auto& block = _blocks[_currentBlock];
+        const std::size_t end = layout(block.used, commandOffset, payloadOffset);
+
+        new(block.data.get() + commandOffset) Command{apply, destroy, entity, type,
+                                                      static_cast<uint32_t>(payloadOffset), static_cast<uint32_t>(end)};
+        block.used = end;
+        ++_commandsCount;
+
+        return block.data.get() + payloadOffset;
+    }
+
+    template<typename Manager>
+    template<typename Fn>
+    void CommandBuffer<Manager>::ForEachCommand(Fn&& fn)
+    {
+        if(_commandsCount == 0)
+            return;
+
+        for(std::size_t i{0}; i<=_currentBlock && i<_blocks.size(); ++i)
+        {
+            auto& block = _blocks[i];
+            std::size_t offset{0};
+
+            while(offset < block.used)
+            {
+                offset = (offset + alignof(Command) - 1) & ~(alignof(Command) - 1);
+
+                auto& command = *std::launder(reinterpret_cast<Command*>(block.data.get() + offset));
+                fn(command, block.data.get() + command.payloadOffset);
+
+                offset = command.next;
+            }
+        }
+    }
+}
+
+#endif
@@ -17,26 +17,53 @@ using namespace MyECS::Debug;
 
 #endif
 
+#ifdef MYECS_INSTRUMENTATION
+#define MYECS_INSTRUMENT(operation) const ScopedLatency myecsLatency_{_latencies[static_cast<std::size_t>(operation)]}
+#else
+#define MYECS_INSTRUMENT(operation)
+#endif
 
 namespace MyECS
 {
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<bool ThreadSafeComponents, typename... Args>
-    Entity EntityManager<entities_capacity, components_capacity, BitsStorageType>::CreateEntity(Args&&... components)
+    Entity EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::CreateEntity(Args&&... components)
     {
+        MYECS_INSTRUMENT(Operation::CreateEntity);
+
         #ifdef DEBUG_MyECS
-            if(_freeEntities.empty() && _activeEntities.size() >= entities_capacity)
+            if(_freeEntities.empty() && _aliveEntities.Size() >= entities_capacity)
             {
                 ENTITY_CAPACITY_EXCEEDED_ERROR(entities_capacity);
                 return 0;
             }
         #endif
 
+        const Entity entity = AllocateEntity();
+        if(entity == InvalidEntity)
+            return InvalidEntity;
+
+        AttachComponents<ThreadSafeComponents>(entity, std::forward<Args>(components)...);
+
+        const auto& slot = _entitiesTable.GetComponents(entity);
+        ForEachInterestedSystem(slot, [entity, &slot](auto& system){ system.OnEntityAdd(entity, slot); });
+
+        return entity;
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    Entity EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::AllocateEntity()
+    {
         Entity entity;
         if(_freeEntities.empty())
         {
-            entity = _activeEntities.size();
+            // index past the capacity would wrap onto slot of another entity
+            if(_aliveEntities.Size() >= entities_capacity)
+                return InvalidEntity;
+
+            entity = MakeEntity(_aliveEntities.Size(), 0);
         }
         else
         {
@@ -44,91 +71,355 @@ namespace MyECS
             _freeEntities.pop_back();
         }
 
+        _entitiesTable.Acquire(entity);
+        _aliveEntities.Insert(entity);
 
-        _entitiesStates.Set(entity);
-        _activeEntities[entity] = entity;
-       (_entitiesComponentsSlots[entity].Set(AddComponent<ThreadSafeComponents>(entity, std::forward<Args>(components))), ...);
+        return entity;
+    }
 
-        for(auto& system : _systems)
-            system->OnEntityAdd(entity, _entitiesComponentsSlots[entity]);
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<bool ThreadSafeComponents, typename... Args>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::AttachComponents([[maybe_unused]] Entity entity, Args&&... components)
+    {
+        (_entitiesTable.GetComponents(entity).Set(AddComponent<ThreadSafeComponents>(entity, std::forward<Args>(components))), ...);
 
-        return entity;
+        // grouped components live in non thread safe storages only
+        if constexpr(!ThreadSafeComponents)
+            JoinGroups(entity);
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<bool ThreadSafeComponents, typename... Args, typename Generator>
+    std::vector<Entity> EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
+    CreateEntities(std::size_t count, Generator&& generator)
+    {
+        std::vector<Entity> entities;
+        entities.reserve(count);
+
+        for(std::size_t i{0}; i<count; ++i)
+        {
+            const Entity entity = AllocateEntity();
+            if(entity == InvalidEntity)
+                break;
+
+            entities.push_back(entity);
+        }
+
+        AttachComponentsBulk<ThreadSafeComponents, Args...>(entities, std::forward<Generator>(generator));
+
+        const auto mask = MakeComponentsMask<Args...>();
+        ForEachInterestedSystem(mask, [&entities, &mask](auto& system){ system.OnEntitiesAdd(entities, mask); });
+
+        return entities;
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<bool ThreadSafeComponents, typename... Args, typename Generator>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
+    AddComponentsBulk(std::span<const Entity> entities, Generator&& generator)
+    {
+        AttachComponentsBulk<ThreadSafeComponents, Args...>(entities, std::forward<Generator>(generator));
+
+        const auto componentsBits = [this](Entity entity) -> const ComponentsBits& {
+            return _entitiesTable.GetComponents(entity);
+        };
+
+        if constexpr(!ThreadSafeComponents)
+        {
+            ForEachInterestedSystem(MakeComponentsMask<Args...>(), [entities, &componentsBits](auto& system){
+                system.OnEntitiesUpdate(entities, componentsBits);
+            });
+        }
+        else
+        {
+            RecordPendingUpdates(entities, MakeComponentsMask<Args...>());
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<bool ThreadSafeComponents, typename... Args, typename Generator>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
+    AttachComponentsBulk(std::span<const Entity> entities, Generator&& generator)
+    {
+        if constexpr(sizeof...(Args) > 0)
+        {
+            // generated components are staged in batches small enough to stay in cache before they're moved to storages
+            static constexpr std::size_t batchSize{1024};
+
+            // tags have no storage, their pointers stay null
+            auto storages = std::make_tuple(AssureStorage<ThreadSafeComponents, Args>()...);
+            std::apply([&entities](auto*... storage){
+                ((storage ? storage->Reserve(storage->Size() + entities.size()) : void()), ...);
+            }, storages);
+
+            std::vector<std::tuple<Args...>> components;
+            components.reserve(std::min(batchSize, entities.size()));
+
+            for(std::size_t begin{0}; begin<entities.size(); begin += batchSize)
+            {
+                const auto batch = entities.subspan(begin, std::min(batchSize, entities.size() - begin));
+
+                components.clear();
+                for(std::size_t i{0}; i<batch.size(); ++i)
+                    components.emplace_back(generator(begin + i));
+
+                [&]<std::size_t ...Indices>(std::index_sequence<Indices...>){
+                    ([&]{
+                        if constexpr(!TagComponent<Args>)
+                            std::get<Indices>(storages)->AddComponentInstances(batch, [&components](std::size_t i) -> Args&& {
+                                return std::move(std::get<Indices>(components[i]));
+                            });
+                    }(), ...);
+                }(std::index_sequence_for<Args...>{});
+            }
+
+            const auto mask = MakeComponentsMask<Args...>();
+            for(const auto entity : entities)
+                _entitiesTable.GetComponents(entity) |= mask;
+
+            if constexpr(!ThreadSafeComponents)
+                if(!_groups.empty())
+                    for(const auto entity : entities)
+                        JoinGroups(entity);
+
+            if constexpr((TagComponent<Args> || ...))
+                _tagsVersion.fetch_add(1, std::memory_order_relaxed);
+
+            (_observers.Record(ComponentId<Args>(), ComponentEvent::Add, entities), ...);
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::Flush(std::span<CommandBufferType> commandBuffers)
+    {
+        std::vector<Entity> provisionalEntities;
+        ///touched entities with their components from before the first command which touched them
+        std::vector<std::pair<Entity, ComponentsBits>> touchedEntities;
+
+        for(auto& commandBuffer : commandBuffers)
+        {
+            provisionalEntities.clear();
+
+            commandBuffer.ForEachCommand([&](auto& command, std::byte* payload){
+                using CommandType = typename CommandBufferType::CommandType;
+
+                if(command.type == CommandType::Create)
+                {
+                    // commands of entity which didn't fit into capacity are dropped as if it was removed
+                    provisionalEntities.push_back(AllocateEntity());
+                    if(provisionalEntities.back() != InvalidEntity)
+                        touchedEntities.emplace_back(provisionalEntities.back(), ComponentsBits{});
+                    return;
+                }
+
+                const Entity entity = (command.entity & CommandBufferType::ProvisionalEntityFlag)
+                        ? provisionalEntities[command.entity & ~CommandBufferType::ProvisionalEntityFlag]
+                        : command.entity;
+
+                // commands of entities removed before (by another buffer or earlier in this one) are dropped
+                if(IsAlive(entity))
+                {
+                    touchedEntities.emplace_back(entity, _entitiesTable.GetComponents(entity));
+                    command.apply(*this, entity, payload);
+                }
+
+                if(command.destroy)
+                    command.destroy(payload);
+
+                command.destroy = nullptr;
+            });
+
+            commandBuffer.Clear();
+        }
+
+        const auto byEntity = [](const auto& lhs, const auto& rhs){ return lhs.first < rhs.first; };
+        const auto sameEntity = [](const auto& lhs, const auto& rhs){ return lhs.first == rhs.first; };
+
+        std::stable_sort(touchedEntities.begin(), touchedEntities.end(), byEntity);
+        touchedEntities.erase(std::unique(touchedEntities.begin(), touchedEntities.end(), sameEntity), touchedEntities.end());
+
+        for(auto& [entity, changedComponents] : touchedEntities)
+            if(IsAlive(entity))
+            {
+                const auto& slot = _entitiesTable.GetComponents(entity);
+                changedComponents |= slot;
+
+                ForEachInterestedSystem(changedComponents, [entity = entity, &slot](auto& system){
+                    system.OnEntityUpdate(entity, slot);
+                });
+            }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::Flush(CommandBufferType& commandBuffer)
+    {
+        Flush(std::span<CommandBufferType>{&commandBuffer, 1});
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<typename DerivedSystemType, typename ...ManagedTypes, template <typename...> class T, typename ...Args>
     requires std::is_base_of_v<System <components_capacity, BitsStorageType>, DerivedSystemType>
-    DerivedSystemType* EntityManager<entities_capacity, components_capacity, BitsStorageType>::
+    DerivedSystemType* EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
     CreateSystem(T<ManagedTypes...>, Args&&... args)
     {
         auto system = new DerivedSystemType(std::forward<Args>(args)...);
         _systems.push_back(std::unique_ptr<System<components_capacity, BitsStorageType>>(system));
 
-        auto managedEntities = GetEntitiesWithComponents<ManagedTypes...>();
-        std::unordered_map<Entity, Entity> managedEntitiesMap;
+        _schedulerOutdated = true;
+
+        const std::size_t systemIndex = _systems.size() - 1;
+        _systemsStamps.push_back(0);
 
-        for(Entity i : managedEntities) managedEntitiesMap[i] = i;
+        if constexpr(sizeof...(ManagedTypes) == 0)
+            _unfilteredSystems.push_back(systemIndex);
 
-        _systems.back()->_managedEntities = std::move(managedEntitiesMap);
+        if constexpr(ComponentsRegistry::Static)
+        {
+            // system built its masks from runtime ids, registered ids replace them
+            auto& registeredSystem = *_systems.back();
+            registeredSystem._managedComponentsBits = MakeComponentsMask<UnwrapComponent<ManagedTypes>...>();
+            registeredSystem._readComponentsBits.ResetAll();
+            registeredSystem._writeComponentsBits.ResetAll();
+
+            ((ComponentAccess<ManagedTypes>::ReadOnly ? registeredSystem._readComponentsBits : registeredSystem._writeComponentsBits)
+                .Set(ComponentId<UnwrapComponent<ManagedTypes>>()), ...);
+        }
+
+        (_componentsSystems[ComponentId<UnwrapComponent<ManagedTypes>>()].push_back(systemIndex), ...);
+
+        auto& managedEntities = _systems.back()->_managedEntities;
+        for(const auto entity : GetEntitiesWithComponents<UnwrapComponent<ManagedTypes>...>())
+            managedEntities.Insert(entity);
 
         return system;
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<bool ThreadSafeComponents, typename... Args>
-    void EntityManager<entities_capacity, components_capacity, BitsStorageType>::AddComponents(Entity entity, Args &&... components)
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::AddComponents(Entity entity, Args &&... components)
     {
+        MYECS_INSTRUMENT(Operation::AddComponents);
+
         #ifdef DEBUG_MyECS
-            if(entity < entities_capacity && _entitiesStates.GetBitState(entity))
+            if(IsAlive(entity))
             {
-                (_entitiesComponentsSlots[entity].Set(AddComponent(entity, std::forward<Args>(components))), ...);
+                (_entitiesTable.GetComponents(entity).Set(AddComponent(entity, std::forward<Args>(components))), ...);
 
-                for(auto& system : _systems)
-                    system->OnEntityUpdate(entity, _entitiesComponentsSlots[entity]);
+                const auto& slot = _entitiesTable.GetComponents(entity);
+                ForEachInterestedSystem(MakeComponentsMask<Args...>(), [entity, &slot](auto& system){
+                    system.OnEntityUpdate(entity, slot);
+                });
             }
             else { ENTITY_ERROR(entity); }
         #else
-            (_entitiesComponentsSlots[entity].Set(AddComponent<ThreadSafeComponents>(entity, std::forward<Args>(components))), ...);
+            AttachComponents<ThreadSafeComponents>(entity, std::forward<Args>(components)...);
 
-            if constexpr(!ThreadSafeComponents)
+            NotifyEntityUpdate<ThreadSafeComponents>(entity, MakeComponentsMask<Args...>());
+        #endif
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<bool ThreadSafeComponent, typename T, typename... CtorArgs>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::EmplaceComponent(Entity entity, CtorArgs&&... args)
+    {
+        MYECS_INSTRUMENT(Operation::AddComponents);
+
+        #ifdef DEBUG_MyECS
+            if(IsAlive(entity))
             {
-                for(auto& system : _systems)
-                    system->OnEntityUpdate(entity, _entitiesComponentsSlots[entity]);
+                if(!_entitiesTable.GetComponents(entity).GetBitState(ComponentId<T>()))
+                {
+                    AssureStorage<ThreadSafeComponent, T>()->EmplaceComponentInstance(entity, std::forward<CtorArgs>(args)...);
+                    _entitiesTable.GetComponents(entity).Set(ComponentId<T>());
+
+                    NotifyEntityUpdate<ThreadSafeComponent>(entity, MakeComponentsMask<T>());
+                }
+                else { ENTITY_ALREADY_HAVE_COMP_ERROR(entity, T); }
             }
+            else { ENTITY_ERROR(entity); }
+        #else
+            if constexpr(!TagComponent<T>)
+                AssureStorage<ThreadSafeComponent, T>()->EmplaceComponentInstance(entity, std::forward<CtorArgs>(args)...);
             else
-            {
-                for(auto& system : _systems)
-                    _pendingUpdates.emplace_back(
-                        [&system, entity, &slot = std::as_const(_entitiesComponentsSlots[entity])]{
-                            system->OnEntityUpdate(entity, slot);
-                        });
-            }
+                _tagsVersion.fetch_add(1, std::memory_order_relaxed);
+            _entitiesTable.GetComponents(entity).Set(ComponentId<T>());
+            _observers.Record(ComponentId<T>(), ComponentEvent::Add, entity);
+            if constexpr(!ThreadSafeComponent)
+                JoinGroups(entity);
 
+            NotifyEntityUpdate<ThreadSafeComponent>(entity, MakeComponentsMask<T>());
         #endif
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<bool Deferred>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
+    NotifyEntityUpdate(Entity entity, const ComponentsBits& changedComponents)
+    {
+        if constexpr(!Deferred)
+        {
+            const auto& slot = _entitiesTable.GetComponents(entity);
+            ForEachInterestedSystem(changedComponents, [entity, &slot](auto& system){
+                system.OnEntityUpdate(entity, slot);
+            });
+        }
+        else
+        {
+            RecordPendingUpdates(std::span<const Entity>{&entity, 1}, changedComponents);
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
+    RecordPendingUpdates(std::span<const Entity> entities, const ComponentsBits& changedComponents)
+    {
+        std::lock_guard<std::mutex> lock{_pendingUpdatesMutex};
+
+        for(const auto entity : entities)
+        {
+            if(_pendingEntities.Contains(entity))
+            {
+                _pendingUpdates[_pendingEntities.IndexOf(entity)].changedComponents |= changedComponents;
+            }
+            else
+            {
+                _pendingEntities.Insert(entity);
+                _pendingUpdates.push_back({entity, changedComponents});
+            }
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<bool ThreadSafeComponent, typename T>
     std::size_t
-    EntityManager<entities_capacity, components_capacity, BitsStorageType>::AddComponent(Entity entity, T&& component)
+    EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::AddComponent(Entity entity, T&& component)
     {
         #ifdef DEBUG_MyECS
-            if(ID::get<T>() < components_capacity)
+            if(ComponentId<T>() < components_capacity)
             {
-                if(!_activeComponentsMask.GetBitState(ID::get<T>()))
+                if(!_activeComponentsMask.GetBitState(ComponentId<T>()))
                 {
-                    _componentStorages[ID::get<T>()] = std::make_unique<ComponentsStorage<components_capacity, BitsStorageType, T>>();
+                    _componentStorages[ComponentId<T>()] = std::make_unique<ComponentsStorage<components_capacity, BitsStorageType, T>>();
                     ++_componentsCount;
-                    _activeComponentsMask.Set(ID::get<T>());
+                    _activeComponentsMask.Set(ComponentId<T>());
                 }
 
-                if(!_entitiesComponentsSlots[entity].GetBitState(ID::get<T>()))
+                if(!_entitiesTable.GetComponents(entity).GetBitState(ComponentId<T>()))
                 {
                     StorageCaster<T>()->AddComponentInstance(entity, std::forward<T>(component));
-                    return ID::get<T>();
+                    return ComponentId<T>();
                 }
                 else { ENTITY_ALREADY_HAVE_COMP_ERROR(entity, T); }
             }
@@ -136,73 +427,180 @@ namespace MyECS
 
             return 0;
         #else
-            if constexpr(!ThreadSafeComponent)
-                if(!_activeComponentsMask.GetBitState(ID::get<T>()))
-                {
-                    _componentStorages[ID::get<T>()] = std::make_unique<ComponentsStorage<components_capacity, BitsStorageType, T, ThreadSafeComponent>>();
-                    ++_componentsCount;
-                    _activeComponentsMask.Set(ID::get<T>());
-                }
-
-            StorageCaster<T, ThreadSafeComponent>()->AddComponentInstance(entity, std::forward<T>(component));
-            return ID::get<T>();
+            if constexpr(!TagComponent<T>)
+                AssureStorage<ThreadSafeComponent, T>()->AddComponentInstance(entity, std::forward<T>(component));
+            else
+                _tagsVersion.fetch_add(1, std::memory_order_relaxed);
+            _observers.Record(ComponentId<T>(), ComponentEvent::Add, entity);
+            return ComponentId<T>();
         #endif
 
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<bool ThreadSafeComponent, typename T>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::AssignComponent(Entity entity, T&& component)
+    {
+        using Component = std::decay_t<T>;
+
+        if constexpr(!TagComponent<Component>)
+        {
+            if constexpr(ThreadSafeComponent)
+            {
+                StorageCaster<Component, true>()->Write(entity, [&component](auto&& instance){ instance = std::forward<T>(component); });
+            }
+            else
+            {
+                StorageCaster<Component, false>()->GetByEntity(entity) = std::forward<T>(component);
+                StorageCaster<Component, false>()->MarkChanged(entity);
+            }
+
+            _observers.Record(ComponentId<Component>(), ComponentEvent::Change, entity);
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<bool ThreadSafeComponent, typename T>
+    typename EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::template ComponentsStorageType<T, ThreadSafeComponent>*
+    EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::AssureStorage()
+    {
+        if constexpr(TagComponent<T>)
+        {
+            return nullptr;
+        }
+        else if constexpr(!ComponentsRegistry::Static)
+        {
+            if(!_activeComponentsMask.GetBitState(ComponentId<T>()))
+            {
+                _componentStorages[ComponentId<T>()] = std::make_unique<ComponentsStorageType<T, ThreadSafeComponent>>(_resource);
+                ++_componentsCount;
+                _activeComponentsMask.Set(ComponentId<T>());
+            }
+
+            return StorageCaster<T, ThreadSafeComponent>();
+        }
+        else
+        {
+            return StorageCaster<T, ThreadSafeComponent>();
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<typename ...Args>
-    void EntityManager<entities_capacity, components_capacity, BitsStorageType>::DetachComponents(Entity entity)
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::DetachComponents(Entity entity)
     {
+        MYECS_INSTRUMENT(Operation::DetachComponents);
+
         #ifdef DEBUG_MyECS
-            if(_entitiesStates.GetBitState(entity))
+            if(IsAlive(entity))
             {
                 (DetachComponent<Args>(entity), ...);
 
-                for(auto& system : _systems)
-                    system->OnEntityUpdate(entity, _entitiesComponentsSlots[entity]);
+                const auto& slot = _entitiesTable.GetComponents(entity);
+                ForEachInterestedSystem(MakeComponentsMask<Args...>(), [entity, &slot](auto& system){
+                    system.OnEntityUpdate(entity, slot);
+                });
             }
             else { ENTITY_ERROR(entity); }
         #else
             (DetachComponent<Args>(entity), ...);
-            for(auto& system : _systems)
-                system->OnEntityUpdate(entity, _entitiesComponentsSlots[entity]);
+
+            const auto& slot = _entitiesTable.GetComponents(entity);
+            ForEachInterestedSystem(MakeComponentsMask<Args...>(), [entity, &slot](auto& system){
+                system.OnEntityUpdate(entity, slot);
+            });
         #endif
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<typename T>
-    void EntityManager<entities_capacity, components_capacity, BitsStorageType>::DetachComponent(Entity entity)
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::DetachComponent(Entity entity)
     {
         #ifdef DEBUG_MyECS
-            if(ID::get<T>() < components_capacity)
+            if(ComponentId<T>() < components_capacity)
             {
-                if(_entitiesComponentsSlots[entity].GetBitState(ID::get<T>()))
+                if(_entitiesTable.GetComponents(entity).GetBitState(ComponentId<T>()))
                 {
-                    _componentStorages[ID::get<T>()]->DeleteComponentInstance(entity);
-                    _entitiesComponentsSlots[entity].Reset(ID::get<T>());
+                    DeleteComponentInstance<T>(entity);
+                    _entitiesTable.GetComponents(entity).Reset(ComponentId<T>());
                 }
                 else { ENTITY_DOES_NOT_HAVE_COMPONENT_ERROR(entity, T); }
             }
             else { COMPONENT_COUNT_EXCEEDED_ERROR(); }
         #else
-            _componentStorages[ID::get<T>()]->DeleteComponentInstance(entity);
-            _entitiesComponentsSlots[entity].Reset(ID::get<T>());
+            DeleteComponentInstance<T>(entity);
+            _entitiesTable.GetComponents(entity).Reset(ComponentId<T>());
+            _observers.Record(ComponentId<T>(), ComponentEvent::Remove, entity);
         #endif
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<typename T>
-    bool EntityManager<entities_capacity, components_capacity, BitsStorageType>::HasComponent(Entity entity) const
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::DeleteComponentInstance(Entity entity)
+    {
+        if constexpr(TagComponent<T>)
+        {
+            _tagsVersion.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            LeaveGroups(entity, MakeComponentsMask<T>());
+
+            if constexpr(ComponentsRegistry::Static)
+                std::get<ComponentId<T>()>(_registeredStorages).DeleteComponentInstance(entity);
+            else
+                _componentStorages[ComponentId<T>()]->DeleteComponentInstance(entity);
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
+    DeleteComponentInstances(Entity entity, const ComponentsBits& components)
+    {
+        LeaveGroups(entity, components);
+
+        if constexpr(ComponentsRegistry::Static)
+        {
+            // storages are reached by their static type, so deletes are direct calls
+            [&]<std::size_t ...Ids>(std::index_sequence<Ids...>){
+                ([&]{
+                    if(!components.GetBitState(Ids))
+                        return;
+
+                    if constexpr(TagComponent<typename ComponentsRegistry::template TypeAt<Ids>>)
+                        _tagsVersion.fetch_add(1, std::memory_order_relaxed);
+                    else
+                        std::get<Ids>(_registeredStorages).DeleteComponentInstance(entity);
+                }(), ...);
+            }(std::make_index_sequence<ComponentsRegistry::Count>{});
+        }
+        else
+        {
+            // tags have no storage
+            for(const auto id : components.Ones())
+                if(_componentStorages[id])
+                    _componentStorages[id]->DeleteComponentInstance(entity);
+                else
+                    _tagsVersion.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename T>
+    bool EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::HasComponent(Entity entity) const
     {
         #ifdef DEBUG_MyECS
-            if(entity < entities_capacity && _entitiesStates.GetBitState(entity))
+            if(IsAlive(entity))
             {
-                if(ID::get<T>() < components_capacity)
-                    return _entitiesComponentsSlots[entity].GetBitState(ID::get<T>());
+                if(ComponentId<T>() < components_capacity)
+                    return _entitiesTable.GetComponents(entity).GetBitState(ComponentId<T>());
                 else
                 { COMPONENT_COUNT_EXCEEDED_ERROR(); }
             }
@@ -211,43 +609,59 @@ namespace MyECS
 
             return false;
         #else
-            return _entitiesComponentsSlots[entity].GetBitState(ID::get<T>());
+            const auto* components = _entitiesTable.FindComponents(entity);
+            return components && components->GetBitState(ComponentId<T>());
         #endif
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<typename... Args>
-    bool EntityManager<entities_capacity, components_capacity, BitsStorageType>::HasComponents(Entity entity) const
+    bool EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::HasComponents(Entity entity) const
     {
         #ifdef DEBUG_MyECS
-            if(entity < entities_capacity && _entitiesStates.GetBitState(entity))
+            if(IsAlive(entity))
             {
-                if(((ID::get<Args>() < components_capacity) && ...))
-                    return (_entitiesComponentsSlots[entity].GetBitState(ID::get<Args>()) && ...);
+                if(((ComponentId<Args>() < components_capacity) && ...))
+                    return (_entitiesTable.GetComponents(entity).GetBitState(ComponentId<Args>()) && ...);
                 else { COMPONENT_COUNT_EXCEEDED_ERROR(); }
             }
             else { ENTITY_ERROR(entity); }
 
             return false;
         #else
-            return (_entitiesComponentsSlots[entity].GetBitState(ID::get<Args>()) && ...);
+            const auto* components = _entitiesTable.FindComponents(entity);
+            if(!components)
+                return false;
+
+            if constexpr(ComponentsRegistry::Static)
+            {
+                static constexpr ComponentsBits mask = MakeComponentsMask<Args...>();
+                return mask.DoesAndEqualThis(*components);
+            }
+            else
+            {
+                return (components->GetBitState(ComponentId<Args>()) && ...);
+            }
         #endif
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<typename ...Args>
     EntityComponentsReturnType<Args...>
-    EntityManager<entities_capacity, components_capacity, BitsStorageType>::GetEntityComponents(Entity entity)
+    EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::GetEntityComponents(Entity entity)
     {
         #ifdef DEBUG_MyECS
-            if(entity < entities_capacity && _entitiesStates.GetBitState(entity))
+            if(IsAlive(entity))
             {
-                if(((ID::get<Args>() < components_capacity) && ...))
+                if(((ComponentId<Args>() < components_capacity) && ...))
                 {
-                    if ((_entitiesComponentsSlots[entity].GetBitState(ID::get<Args>()) && ...))
+                    if ((_entitiesTable.GetComponents(entity).GetBitState(ComponentId<Args>()) && ...))
+                    {
+                        (StorageCaster<Args>()->MarkChanged(entity), ...);
                         return std::tuple<Args*...>{StorageCaster<Args>()->GetByEntity(entity)...};
+                    }
                     else
                         return {};
                 }
@@ -257,22 +671,24 @@ namespace MyECS
 
             return {};
         #else
+            (StorageCaster<Args, false>()->MarkChanged(entity), ...);
+            (_observers.Record(ComponentId<Args>(), ComponentEvent::Change, entity), ...);
             return {StorageCaster<Args, false>()->GetByEntity(entity)...};
         #endif
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<bool ThreadSafeComponents, typename... Args>
     EntityComponentsReturnType_const<Args...>
-    EntityManager<entities_capacity, components_capacity, BitsStorageType>::GetEntityComponents(Entity entity) const
+    EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::GetEntityComponents(Entity entity) const
     {
         #ifdef DEBUG_MyECS
-            if(entity < entities_capacity && _entitiesStates.GetBitState(entity))
+            if(IsAlive(entity))
             {
-                if(((ID::get<Args>() < components_capacity) && ...))
+                if(((ComponentId<Args>() < components_capacity) && ...))
                 {
-                    if ((_entitiesComponentsSlots[entity].GetBitState(ID::get<Args>()) && ...))
+                    if ((_entitiesTable.GetComponents(entity).GetBitState(ComponentId<Args>()) && ...))
                         return std::tuple<const Args*...>{StorageCaster<Args>()->GetByEntity(entity)...};
                     else
                         return {};
@@ -287,91 +703,351 @@ namespace MyECS
         #endif
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename... Args>
+    std::tuple<Args...> EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
+    GetEntityComponentsCopy(Entity entity) const
+    {
+        return {StorageCaster<Args, true>()->GetCopyByEntity(entity)...};
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename T, typename Fn>
+    decltype(auto) EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
+    ReadComponent(Entity entity, Fn&& fn) const
+    {
+        return StorageCaster<T, true>()->Read(entity, std::forward<Fn>(fn));
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<typename... Args>
     std::vector<Entity>
-    EntityManager<entities_capacity, components_capacity, BitsStorageType>::GetEntitiesWithComponents()
+    EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::GetEntitiesWithComponents()
     {
-        std::vector<Entity> result(_activeEntities.size());
+        std::vector<Entity> result;
+        result.reserve(_aliveEntities.Size());
 
-        for(const auto entity : _activeEntities)
-            if(HasComponents<Args...>(entity.second))
-                result.push_back(entity.second);
+        for(const auto entity : _aliveEntities.GetEntities())
+            if(HasComponents<Args...>(entity))
+                result.push_back(entity);
 
         return result;
     }
 
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename... Args>
+    constexpr Bits<BitsStorageType, components_capacity>
+    EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::MakeComponentsMask()
+    {
+        ComponentsBits mask;
+        (mask.Set(ComponentId<Args>()), ...);
+
+        return mask;
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename Fn>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
+    ForEachInterestedSystem(const ComponentsBits& components, Fn&& fn)
+    {
+        MYECS_INSTRUMENT(Operation::NotifySystems);
+
+        struct DepthGuard
+        {
+            uint32_t& depth;
+            ~DepthGuard() { --depth; }
+        };
+
+        // system's action changing components notifies from inside of this one, nested notifications dedupe
+        // with their own visited flags so the stamps of the outer one stay intact
+        const bool nested = _notificationsDepth++ > 0;
+        const DepthGuard guard{_notificationsDepth};
+
+        std::vector<bool> visited;
+        if(nested)
+        {
+            visited.resize(_systems.size());
+        }
+        else if(++_currentStamp == 0)
+        {
+            std::fill(_systemsStamps.begin(), _systemsStamps.end(), 0);
+            _currentStamp = 1;
+        }
+
+        const auto firstVisit = [&](std::size_t system){
+            if(nested)
+                return !visited[system] && (visited[system] = true);
+
+            if(_systemsStamps[system] == _currentStamp)
+                return false;
+
+            _systemsStamps[system] = _currentStamp;
+            return true;
+        };
+
+        for(const auto system : _unfilteredSystems)
+            fn(*_systems[system]);
+
+        for(const auto id : components.Ones())
+            for(const auto system : _componentsSystems[id])
+                if(firstVisit(system))
+                    fn(*_systems[system]);
+    }
+
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename T, typename Fn>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::ParallelEach(Fn&& fn, std::size_t grainSize)
+    {
+        static constexpr std::size_t cacheLineSize{64};
+        // chunks of lcm(line, size) / size components span whole lines, that's at most 64 components (odd sizes)
+        static constexpr auto componentsPerLines = [](std::size_t size){ return cacheLineSize / std::gcd(cacheLineSize, size); };
+
+        auto* storage = StorageCaster<T, false>();
+        if(!storage || storage->Size() == 0)
+            return;
+
+        const Entity* entities = storage->GetEntities().data();
+        const std::size_t count = storage->Size();
+        auto& threadPool = GetThreadPool();
+
+        if constexpr(SoAComponent<T>)
+        {
+            // member arrays start at cache line boundaries, chunks covering whole lines of every member keep them there
+            // (counts are powers of two, so the largest one is a multiple of the others)
+            static constexpr std::size_t componentsPerLine = []<std::size_t ...I>(std::index_sequence<I...>){
+                return std::max({componentsPerLines(sizeof(Detail::SoAField<T, I>))...});
+            }(std::make_index_sequence<Detail::SoAFieldsCount<T>>{});
+            auto& components = storage->_componentInstances;
+
+            if(grainSize == 0)
+                grainSize = std::max(count / (threadPool.ThreadsCount() * 4), componentsPerLine);
+
+            grainSize = ((grainSize + componentsPerLine - 1) / componentsPerLine) * componentsPerLine;
+
+            threadPool.ParallelFor(grainSize, count, grainSize, [&fn, &components, entities](std::size_t begin, std::size_t end){
+                if constexpr(std::is_invocable_v<Fn&, std::span<const Entity>, SoASpan<T>>)
+                {
+                    fn(std::span<const Entity>{entities + begin, end - begin}, components.Slice(begin, end - begin));
+                }
+                else
+                {
+                    for(std::size_t i{begin}; i<end; ++i)
+                        fn(entities[i], components[i]);
+                }
+            });
+        }
+        else
+        {
+            static constexpr std::size_t componentsPerLine = componentsPerLines(sizeof(T));
+
+            T* components = storage->_componentInstances.data();
+
+            if(grainSize == 0)
+                grainSize = std::max(count / (threadPool.ThreadsCount() * 4), componentsPerLine);
+
+            grainSize = ((grainSize + componentsPerLine - 1) / componentsPerLine) * componentsPerLine;
+
+            // first chunk is stretched up to the first component starting a line, if there's one, the others follow it
+            std::size_t firstEnd{grainSize};
+            if constexpr(componentsPerLine > 1)
+            {
+                const auto address = reinterpret_cast<std::uintptr_t>(components);
+                for(std::size_t i{0}; i<componentsPerLine; ++i)
+                    if((address + i * sizeof(T)) % cacheLineSize == 0)
+                    {
+                        firstEnd += i;
+                        break;
+                    }
+            }
+
+            threadPool.ParallelFor(firstEnd, count, grainSize, [&fn, components, entities](std::size_t begin, std::size_t end){
+                if constexpr(std::is_invocable_v<Fn&, std::span<const Entity>, std::span<T>>)
+                {
+                    fn(std::span<const Entity>{entities + begin, end - begin}, std::span<T>{components + begin, end - begin});
+                }
+                else
+                {
+                    for(std::size_t i{begin}; i<end; ++i)
+                        fn(entities[i], components[i]);
+                }
+            });
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename... Args>
+    View<EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>, Args...>
+    EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::GetView()
+    {
+        return View<EntityManager, Args...>{this};
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename... Args>
+    bool EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::CreateGroup()
+    {
+        static_assert(sizeof...(Args) > 0 && !(TagComponent<Args> || ...), "group needs components with instances");
+        using Leading = std::tuple_element_t<0, std::tuple<Args...>>;
+
+        const auto components = MakeComponentsMask<Args...>();
+        for(const auto& group : _groups)
+            if(group.components.IsAndNonZero(components))
+                return false;
+
+        (AssureStorage<false, Args>(), ...);
+
+        static constexpr auto place = [](EntityManager& manager, Entity entity, std::size_t position){
+            ([entity, position](auto* storage){
+                if(const auto index = storage->IndexOf(entity); index != position)
+                    storage->Swap(index, position);
+            }(manager.template StorageCaster<Args, false>()), ...);
+        };
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+        static constexpr auto indexOf = [](const EntityManager& manager, Entity entity){
+            return manager.template StorageCaster<Leading, false>()->IndexOf(entity);
+        };
+
+        _groups.push_back({components, 0, place, indexOf});
+
+        // entities are joined one by one, which reorders the storage, so they're copied first
+        const std::vector<Entity> entities = StorageCaster<Leading, false>()->GetEntities();
+        for(const auto entity : entities)
+            JoinGroups(entity);
+
+        return true;
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
-    void EntityManager<entities_capacity, components_capacity, BitsStorageType>::RemoveEntity(Entity entity)
+    template<typename... Args, typename Fn>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::EachInGroup(Fn&& fn)
     {
+        using Leading = std::tuple_element_t<0, std::tuple<Args...>>;
+
+        const auto components = MakeComponentsMask<Args...>();
+        const auto group = std::find_if(_groups.begin(), _groups.end(), [&components](const Group& group){
+            return components.DoesAndEqualThis(group.components);
+        });
+
+        if(group == _groups.end())
+            return;
+
+        // the first size instances of every storage of the group belong to the same entities
+        const Entity* entities = StorageCaster<Leading, false>()->GetEntities().data();
+        auto columns = std::forward_as_tuple(StorageCaster<Args, false>()->_componentInstances...);
+
+        for(std::size_t i{0}; i<group->size; ++i)
+            std::apply([&fn, entity = entities[i], i](auto&... column){ fn(entity, column[i]...); }, columns);
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::RemoveEntity(Entity entity)
+    {
+        MYECS_INSTRUMENT(Operation::RemoveEntity);
+
         #ifdef DEBUG_MyECS
-            if(_entitiesStates.GetBitState(entity))
+            if(IsAlive(entity))
             {
-                for(std::size_t i{0}; i<_componentsCount; ++i)
-                    if(_componentStorages[i] && _componentStorages[i]->GetBits().IsAndNonZero(_entitiesComponentsSlots[entity]))
-                        _componentStorages[i]->DeleteComponentInstance(entity);
+                DeleteComponentInstances(entity, _entitiesTable.GetComponents(entity));
 
-                for(auto& system : _systems)
-                    system->OnEntityRemove(entity);
+                ForEachInterestedSystem(_entitiesTable.GetComponents(entity), [entity](auto& system){
+                    system.OnEntityRemove(entity);
+                });
 
-                _entitiesStates.Reset(entity);
-                _entitiesComponentsSlots[entity].ResetAll();
-                _freeEntities.push_back(entity);
-                _activeEntities.erase(entity);
+                ReleaseEntity(entity);
             }
             else { ENTITY_ERROR(entity); }
         #else
 
-            for(std::size_t i{0}; i<_componentsCount; ++i)
-                if(_componentStorages[i]->GetBits().IsAndNonZero(_entitiesComponentsSlots[entity]))
-                    _componentStorages[i]->DeleteComponentInstance(entity);
+            if(_observers.ObservesAny(ComponentEvent::Remove))
+            {
+                const auto& components = _entitiesTable.GetComponents(entity);
+                for(const auto id : components.Ones())
+                    _observers.Record(id, ComponentEvent::Remove, entity);
+            }
+
+            DeleteComponentInstances(entity, _entitiesTable.GetComponents(entity));
 
-            for(auto& system : _systems)
-                system->OnEntityRemove(entity);
+            ForEachInterestedSystem(_entitiesTable.GetComponents(entity), [entity](auto& system){
+                system.OnEntityRemove(entity);
+            });
 
-            _entitiesStates.Reset(entity);
-            _entitiesComponentsSlots[entity].ResetAll();
-            _freeEntities.push_back(entity);
-            _activeEntities.erase(entity);
+            ReleaseEntity(entity);
         #endif
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
-    void EntityManager<entities_capacity, components_capacity, BitsStorageType>::ExecPendingUpdates()
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::ReleaseEntity(Entity entity)
     {
-        while(!_pendingUpdates.empty())
+        const Entity index = GetEntityIndex(entity);
+
+        _entitiesTable.Release(entity);
+        _freeEntities.push_back(MakeEntity(index, GetEntityGeneration(entity) + 1));
+        _aliveEntities.Erase(entity);
+
+        std::lock_guard<std::mutex> lock{_pendingUpdatesMutex};
+        if(_pendingEntities.Contains(entity))
         {
-            _pendingUpdates.front()();
-            _pendingUpdates.pop_front();
+            const auto pendingIndex = _pendingEntities.Erase(entity);
+            _pendingUpdates[pendingIndex] = _pendingUpdates.back();
+            _pendingUpdates.pop_back();
         }
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
-    template<typename T>
-    void EntityManager<entities_capacity, components_capacity, BitsStorageType>::PreinitThreadSafeComponentStorage()
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::ExecPendingUpdates()
     {
-        if(!_activeComponentsMask.GetBitState(ID::get<T>()))
         {
-            _componentStorages[ID::get<T>()] = std::make_unique<ComponentsStorage<components_capacity, BitsStorageType, T, true>>();
-            ++_componentsCount;
-            _activeComponentsMask.Set(ID::get<T>());
+            std::lock_guard<std::mutex> lock{_pendingUpdatesMutex};
+            std::swap(_pendingUpdates, _executedUpdates);
+            _pendingEntities.Clear();
         }
+
+        ComponentsBits changedComponents;
+        for(const auto& update : _executedUpdates)
+            changedComponents |= update.changedComponents;
+
+        ForEachInterestedSystem(changedComponents, [this](auto& system){
+            const bool unfiltered = system._managedComponentsBits == ComponentsBits{};
+
+            for(const auto& update : _executedUpdates)
+                if(unfiltered || system._managedComponentsBits.IsAndNonZero(update.changedComponents))
+                    if(IsAlive(update.entity))
+                        system.OnEntityUpdate(update.entity, _entitiesTable.GetComponents(update.entity));
+        });
+
+        _executedUpdates.clear();
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename T>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::PreinitThreadSafeComponentStorage()
+    {
+        AssureStorage<true, T>();
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<bool ThreadSafeComponents, typename T> ComponentsReturnType_const<T>
-    EntityManager<entities_capacity, components_capacity, BitsStorageType>::GetComponents() const
+    EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::GetComponents() const
     {
         #ifdef DEBUG_MyECS
-            if(ID::get<T>() < components_capacity)
+            if(ComponentId<T>() < components_capacity)
             {
-                if(_componentStorages[ID::get<T>()])
+                if(_componentStorages[ComponentId<T>()])
                     return &StorageCaster<T>()->_componentInstances;
                 else
                 { NON_EXISTENT_COMPONENT_ERROR(T); }
@@ -384,16 +1060,19 @@ namespace MyECS
         #endif
     }
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     template<typename T> ComponentsReturnType<T>
-    EntityManager<entities_capacity, components_capacity, BitsStorageType>::GetComponents()
+    EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::GetComponents()
     {
         #ifdef DEBUG_MyECS
-            if(ID::get<T>() < components_capacity)
+            if(ComponentId<T>() < components_capacity)
             {
-                if(_componentStorages[ID::get<T>()])
+                if(_componentStorages[ComponentId<T>()])
+                {
+                    GetStorage(ComponentId<T>())->MarkAllChanged();
                     return &StorageCaster<T>()->_componentInstances;
+                }
                 else
                 { NON_EXISTENT_COMPONENT_ERROR(T); }
             }
@@ -402,9 +1081,501 @@ namespace MyECS
 
             return {};
         #else
+            GetStorage(ComponentId<T>())->MarkAllChanged();
             return StorageCaster<T, false>()->_componentInstances;
         #endif
     }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    bool EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::SaveSnapshot(std::vector<std::byte>& snapshot) const
+    {
+        std::vector<std::byte> buffer;
+        SnapshotWriter writer{buffer};
+
+        const auto& alive = _aliveEntities.GetEntities();
+        SnapshotHeader header{};
+        header.componentsBitsSize = sizeof(ComponentsBits);
+        header.storagesCount = 0;
+        header.aliveCount = alive.size();
+        header.freeCount = _freeEntities.size();
+
+        writer.Write(header);
+        writer.Write(alive.data(), alive.size() * sizeof(Entity));
+        for(const auto entity : alive)
+            writer.Write(_entitiesTable.GetComponents(entity));
+        writer.Write(_freeEntities.data(), _freeEntities.size() * sizeof(Entity));
+
+        const auto stored = StoredComponents();
+        for(const auto id : stored.Ones())
+        {
+            if(!GetStorage(id)->Save(writer, static_cast<uint32_t>(id)))
+                return false;
+
+            ++header.storagesCount;
+        }
+
+        writer.Patch(0, &header, sizeof(header));
+        snapshot = std::move(buffer);
+
+        return true;
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    bool EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::LoadSnapshot(std::span<const std::byte> snapshot)
+    {
+        SnapshotReader reader{snapshot};
+
+        const auto header = reader.Read<SnapshotHeader>();
+        if(reader.Failed() || header.magic != SnapshotHeader::Magic || header.version != SnapshotHeader::CurrentVersion ||
+           header.componentsBitsSize != sizeof(ComponentsBits) ||
+           header.aliveCount > entities_capacity || header.freeCount > entities_capacity - header.aliveCount)
+            return false;
+
+        const auto aliveBlock = reader.View(header.aliveCount * sizeof(Entity));
+        const auto componentsBlock = reader.View(header.aliveCount * sizeof(ComponentsBits));
+        const auto freeBlock = reader.View(header.freeCount * sizeof(Entity));
+
+        // storage records are checked before anything is replaced
+        SnapshotReader records{reader};
+        for(uint32_t i{0}; i<header.storagesCount && !records.Failed(); ++i)
+        {
+            const auto storageHeader = records.Read<SnapshotStorageHeader>();
+            if(records.Failed() || storageHeader.componentId >= components_capacity || !GetStorage(storageHeader.componentId) ||
+               storageHeader.count > records.Remaining() / sizeof(Entity))
+                return false;
+
+            records.Skip(storageHeader.count * sizeof(Entity));
+            records.Skip(storageHeader.payloadSize);
+        }
+
+        if(records.Failed())
+            return false;
+
+        std::vector<Entity> alive(header.aliveCount);
+        std::vector<Entity> free(header.freeCount);
+        std::memcpy(alive.data(), aliveBlock.data(), aliveBlock.size());
+        std::memcpy(free.data(), freeBlock.data(), freeBlock.size());
+
+        // new entities get index alive + free, so alive and free entities have to occupy exactly the indices below it
+        std::vector<Entity> indices;
+        indices.reserve(alive.size() + free.size());
+        for(const auto entity : alive)
+            indices.push_back(entity & CommandBufferType::ProvisionalEntityFlag ? entities_capacity : GetEntityIndex(entity));
+        for(const auto entity : free)
+            indices.push_back(entity & CommandBufferType::ProvisionalEntityFlag ? entities_capacity : GetEntityIndex(entity));
+
+        std::sort(indices.begin(), indices.end());
+        for(std::size_t i{0}; i<indices.size(); ++i)
+            if(indices[i] != i)
+                return false;
+
+        ClearWorld();
+
+        for(std::size_t i{0}; i<alive.size(); ++i)
+        {
+            _entitiesTable.Acquire(alive[i]);
+            std::memcpy(&_entitiesTable.GetComponents(alive[i]), componentsBlock.data() + i * sizeof(ComponentsBits), sizeof(ComponentsBits));
+            _aliveEntities.Insert(alive[i]);
+        }
+
+        _freeEntities = std::move(free);
+
+        bool loaded{true};
+        for(uint32_t i{0}; i<header.storagesCount && loaded; ++i)
+        {
+            const auto storageHeader = reader.Read<SnapshotStorageHeader>();
+            loaded = GetStorage(storageHeader.componentId)->Load(reader, storageHeader);
+        }
+
+        // every storage has to hold exactly the alive entities with its component bit
+        if(loaded)
+        {
+            std::vector<std::size_t> componentCounts(components_capacity, 0);
+            for(const auto entity : alive)
+                for(const auto id : _entitiesTable.GetComponents(entity).Ones())
+                    ++componentCounts[id];
+
+            std::vector<Entity> stored;
+            const auto storedComponents = StoredComponents();
+            for(const auto id : storedComponents.Ones())
+            {
+                const auto* storage = GetStorage(id);
+                if(!storage)
+                    continue;
+
+                storage->CopyEntities(stored);
+                std::sort(stored.begin(), stored.end());
+                loaded = stored.size() == componentCounts[id] && std::adjacent_find(stored.begin(), stored.end()) == stored.end() &&
+                         std::all_of(stored.begin(), stored.end(), [this, id](Entity entity){
+                             return _entitiesTable.Contains(entity) && _entitiesTable.GetComponents(entity).GetBitState(id);
+                         });
+
+                if(!loaded)
+                    break;
+            }
+        }
+
+        if(!loaded)
+            ClearWorld();
+
+        RebuildGroups();
+        SyncSystemsWithWorld();
+
+        return loaded;
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    Bits<BitsStorageType, components_capacity> EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::StoredComponents() const
+    {
+        if constexpr(ComponentsRegistry::Static)
+        {
+            ComponentsBits components;
+            [&components]<std::size_t ...Ids>(std::index_sequence<Ids...>){
+                ([&components]{
+                    if constexpr(!TagComponent<typename ComponentsRegistry::template TypeAt<Ids>>)
+                        components.Set(Ids);
+                }(), ...);
+            }(std::make_index_sequence<ComponentsRegistry::Count>{});
+
+            return components;
+        }
+        else
+        {
+            return _activeComponentsMask;
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    BaseComponentsStorage<components_capacity, BitsStorageType>* EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::GetStorage(std::size_t componentId) const
+    {
+        if constexpr(ComponentsRegistry::Static)
+        {
+            BaseComponentsStorage<components_capacity, BitsStorageType>* storage{nullptr};
+            [&]<std::size_t ...Ids>(std::index_sequence<Ids...>){
+                ((Ids == componentId ? void(storage = const_cast<std::tuple_element_t<Ids, decltype(_registeredStorages)>*>(
+                    &std::get<Ids>(_registeredStorages))) : void()), ...);
+            }(std::make_index_sequence<ComponentsRegistry::Count>{});
+
+            return storage;
+        }
+        else
+        {
+            return _componentStorages[componentId].get();
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::ClearWorld()
+    {
+        const auto stored = StoredComponents();
+        for(const auto id : stored.Ones())
+            GetStorage(id)->Clear();
+
+        _entitiesTable.Clear();
+        _aliveEntities.Clear();
+        _freeEntities.clear();
+        _observers.Clear();
+        _tagsVersion.fetch_add(1, std::memory_order_relaxed);
+
+        for(auto& group : _groups)
+            group.size = 0;
+
+        std::lock_guard<std::mutex> lock{_pendingUpdatesMutex};
+        _pendingEntities.Clear();
+        _pendingUpdates.clear();
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::JoinGroups(Entity entity)
+    {
+        const auto& components = _entitiesTable.GetComponents(entity);
+        for(auto& group : _groups)
+            if(group.components.DoesAndEqualThis(components))
+            {
+                if(group.indexOf(*this, entity) >= group.size)
+                    group.place(*this, entity, group.size++);
+            }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::
+    LeaveGroups(Entity entity, const ComponentsBits& leaving)
+    {
+        // entity having all components of the group is always in it
+        const auto& components = _entitiesTable.GetComponents(entity);
+        for(auto& group : _groups)
+            if(group.components.IsAndNonZero(leaving) && group.components.DoesAndEqualThis(components))
+                group.place(*this, entity, --group.size);
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::RebuildGroups()
+    {
+        if(_groups.empty())
+            return;
+
+        for(auto& group : _groups)
+            group.size = 0;
+
+        for(const auto entity : _aliveEntities.GetEntities())
+            JoinGroups(entity);
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::SyncSystemsWithWorld()
+    {
+        std::vector<Entity> previousEntities;
+
+        for(auto& system : _systems)
+        {
+            previousEntities = system->_managedEntities.GetEntities();
+            for(const auto entity : previousEntities)
+                if(!IsAlive(entity))
+                    system->OnEntityRemove(entity);
+
+            for(const auto entity : _aliveEntities.GetEntities())
+                system->OnEntityUpdate(entity, _entitiesTable.GetComponents(entity));
+        }
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<bool ThreadSafeComponent, typename T>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::EnableChangeTracking()
+    {
+        static_assert(!TagComponent<T>, "tag components have no instances to track");
+        AssureStorage<ThreadSafeComponent, T>()->EnableChangeTracking(&_changeTick);
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename T>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::MarkChanged(Entity entity)
+    {
+        static_assert(!TagComponent<T>, "tag components have no instances to track");
+        #ifdef DEBUG_MyECS
+            if(HasComponent<T>(entity))
+                GetStorage(ComponentId<T>())->MarkChanged(entity);
+            else
+            { ENTITY_ERROR(entity); }
+        #else
+            GetStorage(ComponentId<T>())->MarkChanged(entity);
+            _observers.Record(ComponentId<T>(), ComponentEvent::Change, entity);
+        #endif
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    ChangeSet EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::CollectChanges(ChangeTick since) const
+    {
+        ChangeSet changes;
+        CollectChanges(since, changes);
+
+        return changes;
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::CollectChanges(ChangeTick since, ChangeSet& changes) const
+    {
+        changes.changed.clear();
+        changes.removed.clear();
+
+        const auto stored = StoredComponents();
+        for(const auto id : stored.Ones())
+            GetStorage(id)->CollectChanges(since, static_cast<uint32_t>(id), changes);
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::DiscardChanges(ChangeTick until)
+    {
+        const auto stored = StoredComponents();
+        for(const auto id : stored.Ones())
+            GetStorage(id)->DiscardChanges(until);
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename Primary>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::Compact()
+    {
+        _defragment.running = false;
+        DefragmentStep<Primary>(std::numeric_limits<std::size_t>::max());
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    template<typename Primary>
+    bool EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::DefragmentStep(std::size_t budget)
+    {
+        auto& state = _defragment;
+        if(!state.running)
+        {
+            state.running = true;
+            state.ordered = false;
+            state.component = 0;
+        }
+
+        const auto stored = StoredComponents();
+        while(true)
+        {
+            while(state.component < components_capacity && !stored.GetBitState(state.component))
+                ++state.component;
+
+            if(state.component == components_capacity)
+                break;
+
+            auto* storage = GetStorage(state.component);
+            if(!state.ordered)
+            {
+                // grouped storages keep the order of their group
+                if(std::any_of(_groups.begin(), _groups.end(), [&state](const Group& group){ return group.components.GetBitState(state.component); }))
+                {
+                    storage->Shrink();
+                    ++state.component;
+                    continue;
+                }
+
+                // instances are arranged in order of entities of the leading storage
+                std::size_t leader{state.component};
+                if constexpr(!std::is_void_v<Primary>)
+                {
+                    // primary storage keeps its own order
+                    if(state.component == ComponentId<Primary>())
+                    {
+                        storage->Shrink();
+                        ++state.component;
+                        continue;
+                    }
+
+                    if(stored.GetBitState(ComponentId<Primary>()))
+                        leader = ComponentId<Primary>();
+                }
+
+                GetStorage(leader)->CopyEntities(state.order);
+                if(leader == state.component)
+                    std::sort(state.order.begin(), state.order.end(), [](Entity lhs, Entity rhs){
+                        return GetEntityIndex(lhs) < GetEntityIndex(rhs);
+                    });
+
+                state.ordered = true;
+                state.cursor = 0;
+                state.position = 0;
+            }
+
+            if(budget == 0)
+                return false;
+
+            const auto count = std::min(budget, state.order.size() - state.cursor);
+            state.position = storage->Arrange(std::span<const Entity>{state.order}.subspan(state.cursor, count), state.position);
+            state.cursor += count;
+            budget -= count;
+
+            if(state.cursor == state.order.size())
+            {
+                storage->Shrink();
+                state.ordered = false;
+                ++state.component;
+            }
+        }
+
+        // free slots are taken from the back
+        std::sort(_freeEntities.begin(), _freeEntities.end(), [](Entity lhs, Entity rhs){
+            return GetEntityIndex(lhs) > GetEntityIndex(rhs);
+        });
+
+        state.running = false;
+        state.order.clear();
+
+        return true;
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::UpdateSystems()
+    {
+        _observers.Dispatch();
+
+        if(_schedulerOutdated)
+        {
+            _scheduler.Build(_systems);
+            _schedulerOutdated = false;
+        }
+
+#ifdef MYECS_INSTRUMENTATION
+        const auto start = std::chrono::steady_clock::now();
+        _scheduler.Run(GetThreadPool(), &_trace);
+        if(_trace.IsRecording())
+            _trace.Record("Frame", "frame", start, std::chrono::steady_clock::now() - start);
+#else
+        _scheduler.Run(GetThreadPool());
+#endif
+    }
+
+#ifdef MYECS_INSTRUMENTATION
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    WorldStats EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::GetStats() const
+    {
+        WorldStats stats;
+        stats.aliveEntities = _aliveEntities.Size();
+        stats.freeEntities = _freeEntities.size();
+        stats.entityPages = _entitiesTable.PagesCount();
+        stats.entityTableBytes = _entitiesTable.MemoryUsage() + _aliveEntities.MemoryUsage() + _freeEntities.capacity() * sizeof(Entity);
+
+        const auto slots = stats.entityPages * _entitiesTable.PageSize();
+        stats.entityTableFragmentation = slots ? 1.0 - static_cast<double>(stats.aliveEntities) / static_cast<double>(slots) : 0.0;
+        stats.systemsCount = _systems.size();
+
+        for(std::size_t i{0}; i<_latencies.size(); ++i)
+            stats.operations[i] = _latencies[i].Read();
+
+        const auto stored = StoredComponents();
+        for(const auto id : stored.Ones())
+            stats.storages.push_back(GetStorage(id)->GetStats(id));
+
+        return stats;
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::ResetStats()
+    {
+        for(auto& histogram : _latencies)
+            histogram.Reset();
+    }
+#endif
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    void EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::UseThreadPool(ThreadPool& threadPool)
+    {
+        _threadPool = &threadPool;
+        _ownThreadPool.reset();
+    }
+
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType, typename ComponentsRegistry>
+    requires std::is_unsigned_v<BitsStorageType>
+    ThreadPool& EntityManager<entities_capacity, components_capacity, BitsStorageType, ComponentsRegistry>::GetThreadPool()
+    {
+        if(!_threadPool)
+        {
+            _ownThreadPool = std::make_unique<ThreadPool>();
+            _threadPool = _ownThreadPool.get();
+        }
+
+        return *_threadPool;
+    }
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef MYECS_ENTITYTABLE_IMPL_TPP
+#define MYECS_ENTITYTABLE_IMPL_TPP
+
+#include <Inc/EntityTable.h>
+
+namespace MyECS
+{
+    template<typename Components, std::size_t page_size> requires (std::has_single_bit(page_size))
+    bool EntityTable<Components, page_size>::Contains(Entity entity) const
+    {
+        const std::size_t page = GetEntityIndex(entity) >> _pageShift;
+
+        // free slots hold InvalidEntity
+        return entity != InvalidEntity && page < _pages.size() && _pages[page] &&
+               _pages[page]->handles[GetEntityIndex(entity) & _pageMask] == entity;
+    }
+
+    template<typename Components, std::size_t page_size> requires (std::has_single_bit(page_size))
+    void EntityTable<Components, page_size>::Acquire(Entity entity)
+    {
+        const std::size_t page = GetEntityIndex(entity) >> _pageShift;
+
+        if(page >= _pages.size())
+            _pages.resize(page + 1);
+
+        if(!_pages[page])
+        {
+            if(_sparePage)
+            {
+                _pages[page] = std::move(_sparePage);
+            }
+            else
+            {
+                _pages[page] = std::make_unique<Page>();
+                _pages[page]->handles.fill(InvalidEntity);
+            }
+
+            ++_pagesCount;
+        }
+
+        auto& target = *_pages[page];
+        target.handles[GetEntityIndex(entity) & _pageMask] = entity;
+        target.components[GetEntityIndex(entity) & _pageMask].ResetAll();
+        ++target.occupied;
+    }
+
+    template<typename Components, std::size_t page_size> requires (std::has_single_bit(page_size))
+    void EntityTable<Components, page_size>::Release(Entity entity)
+    {
+        auto& page = _pages[GetEntityIndex(entity) >> _pageShift];
+
+        page->handles[GetEntityIndex(entity) & _pageMask] = InvalidEntity;
+
+        if(--page->occupied == 0)
+        {
+            // every handle of the page is invalid now, so it can be handed out again as is
+            _sparePage = std::move(page);
+            --_pagesCount;
+        }
+    }
+}
+
+#endif
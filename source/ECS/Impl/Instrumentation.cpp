@@ -0,0 +1,177 @@
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+
+using namespace MyECS;
+
+const char* MyECS::OperationName(Operation operation)
+{
+    switch(operation)
+    {
+        case Operation::CreateEntity: return "CreateEntity";
+        case Operation::AddComponents: return "AddComponents";
+        case Operation::DetachComponents: return "DetachComponents";
+        case Operation::RemoveEntity: return "RemoveEntity";
+        case Operation::NotifySystems: return "NotifySystems";
+        default: return "Unknown";
+    }
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds duration)
+{
+    const auto ns = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+    const auto bucket = std::min<std::size_t>(std::bit_width(ns), BucketsCount - 1);
+
+    _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _totalNs.fetch_add(ns, std::memory_order_relaxed);
+
+    auto max = _maxNs.load(std::memory_order_relaxed);
+    while(ns > max && !_maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed));
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::Read() const
+{
+    Snapshot snapshot;
+    for(std::size_t i{0}; i<BucketsCount; ++i)
+        snapshot.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+
+    snapshot.count = _count.load(std::memory_order_relaxed);
+    snapshot.totalNs = _totalNs.load(std::memory_order_relaxed);
+    snapshot.maxNs = _maxNs.load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+void LatencyHistogram::Reset()
+{
+    for(auto& bucket : _buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    _count.store(0, std::memory_order_relaxed);
+    _totalNs.store(0, std::memory_order_relaxed);
+    _maxNs.store(0, std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds LatencyHistogram::Snapshot::Percentile(double quantile) const
+{
+    // buckets are read one by one while others may record, so their sum is used instead of count
+    uint64_t total{0};
+    for(const auto bucket : buckets)
+        total += bucket;
+
+    const auto target = static_cast<uint64_t>(quantile * static_cast<double>(total));
+    uint64_t seen{0};
+    for(std::size_t i{0}; i<BucketsCount; ++i)
+    {
+        seen += buckets[i];
+        if(seen > target || (seen == total && seen != 0))
+            return std::chrono::nanoseconds{std::min<uint64_t>(uint64_t{1} << i, std::max<uint64_t>(maxNs, 1))};
+    }
+
+    return std::chrono::nanoseconds{0};
+}
+
+void TraceRecorder::Start()
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(_events.empty())
+        _origin = std::chrono::steady_clock::now();
+
+    _recording.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::Record(std::string_view name, const char* category,
+                           std::chrono::steady_clock::time_point start, std::chrono::nanoseconds duration)
+{
+    if(!IsRecording())
+        return;
+
+    std::lock_guard<std::mutex> lock{_mutex};
+    // events which began before Start are clipped to the origin
+    const auto begin = std::max<std::chrono::nanoseconds>(start - _origin, std::chrono::nanoseconds{0});
+    _events.push_back({std::string{name}, category, begin, duration, ThreadIdOf(std::this_thread::get_id())});
+}
+
+std::size_t TraceRecorder::EventsCount() const
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    return _events.size();
+}
+
+void TraceRecorder::Clear()
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    _events.clear();
+    _origin = std::chrono::steady_clock::now();
+}
+
+uint32_t TraceRecorder::ThreadIdOf(std::thread::id thread)
+{
+    const auto it = std::find(_threads.begin(), _threads.end(), thread);
+    if(it != _threads.end())
+        return static_cast<uint32_t>(it - _threads.begin());
+
+    _threads.push_back(thread);
+    return static_cast<uint32_t>(_threads.size() - 1);
+}
+
+namespace
+{
+    void AppendEscaped(std::string& json, std::string_view text)
+    {
+        for(const char c : text)
+        {
+            if(c == '"' || c == '\\')
+                json += '\\';
+
+            if(static_cast<unsigned char>(c) >= 0x20)
+                json += c;
+        }
+    }
+
+    void AppendMicroseconds(std::string& json, std::chrono::nanoseconds time)
+    {
+        // chrome trace timestamps are microseconds, fractional part keeps nanosecond precision
+        json += std::to_string(time.count() / 1000);
+        json += '.';
+
+        const auto fraction = std::to_string(time.count() % 1000 + 1000);
+        json += fraction.substr(1);
+    }
+}
+
+std::string TraceRecorder::ToChromeTraceJson() const
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    std::string json{"{\"displayTimeUnit\":\"ns\",\"traceEvents\":["};
+    for(std::size_t i{0}; i<_events.size(); ++i)
+    {
+        const auto& event = _events[i];
+        json += i ? ",{\"name\":\"" : "{\"name\":\"";
+        AppendEscaped(json, event.name);
+        json += "\",\"cat\":\"";
+        AppendEscaped(json, event.category);
+        json += "\",\"ph\":\"X\",\"pid\":0,\"tid\":";
+        json += std::to_string(event.threadId);
+        json += ",\"ts\":";
+        AppendMicroseconds(json, event.start);
+        json += ",\"dur\":";
+        AppendMicroseconds(json, event.duration);
+        json += '}';
+    }
+    json += "]}";
+
+    return json;
+}
+
+bool TraceRecorder::WriteChromeTrace(const char* path) const
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file << ToChromeTraceJson();
+
+    return static_cast<bool>(file);
+}
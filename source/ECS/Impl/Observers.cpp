@@ -0,0 +1,98 @@
+#include "Observers.h"
+
+#include <algorithm>
+
+using namespace MyECS;
+
+Observers::Observers(std::size_t componentsCapacity)
+    : _observers(componentsCapacity), _observed(componentsCapacity, 0), _pending(componentsCapacity), _dispatching(componentsCapacity)
+{
+}
+
+ObserverId Observers::Add(std::size_t componentId, ComponentEvent event, Callback callback)
+{
+    const ObserverId id = _nextId++;
+    _observers[componentId].push_back({id, event, std::move(callback)});
+    _observed[componentId] |= 1u << static_cast<uint8_t>(event);
+    ++_observersCount[static_cast<std::size_t>(event)];
+
+    return id;
+}
+
+bool Observers::Remove(ObserverId id)
+{
+    for(std::size_t component{0}; component<_observers.size(); ++component)
+    {
+        auto& observers = _observers[component];
+        const auto it = std::find_if(observers.begin(), observers.end(), [id](const Observer& observer){ return observer.id == id; });
+        if(it == observers.end())
+            continue;
+
+        const auto event = it->event;
+        observers.erase(it);
+        --_observersCount[static_cast<std::size_t>(event)];
+
+        if(std::none_of(observers.begin(), observers.end(), [event](const Observer& observer){ return observer.event == event; }))
+            _observed[component] &= ~(1u << static_cast<uint8_t>(event));
+
+        return true;
+    }
+
+    return false;
+}
+
+void Observers::Append(std::size_t componentId, ComponentEvent event, std::span<const Entity> entities)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    auto& queue = _pending[componentId];
+    if(!queue.queued)
+    {
+        queue.queued = true;
+        _pendingComponents.push_back(componentId);
+    }
+
+    auto& events = queue.entities[static_cast<std::size_t>(event)];
+    events.insert(events.end(), entities.begin(), entities.end());
+}
+
+void Observers::Queue::Clear()
+{
+    for(auto& events : entities)
+        events.clear();
+    queued = false;
+}
+
+void Observers::Dispatch()
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        std::swap(_pending, _dispatching);
+        std::swap(_pendingComponents, _dispatchingComponents);
+    }
+
+    for(const auto component : _dispatchingComponents)
+    {
+        auto& queue = _dispatching[component];
+
+        for(const auto& observer : _observers[component])
+        {
+            const auto& batch = queue.entities[static_cast<std::size_t>(observer.event)];
+            if(!batch.empty())
+                observer.callback(std::span<const Entity>{batch});
+        }
+
+        queue.Clear();
+    }
+
+    _dispatchingComponents.clear();
+}
+
+void Observers::Clear()
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    for(const auto component : _pendingComponents)
+        _pending[component].Clear();
+
+    _pendingComponents.clear();
+}
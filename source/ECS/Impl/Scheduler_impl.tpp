@@ -0,0 +1,124 @@
+#ifndef MYECS_SCHEDULER_IMPL_TPP
+#define MYECS_SCHEDULER_IMPL_TPP
+
+#include <Inc/Scheduler.h>
+
+namespace MyECS
+{
+    template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
+    void Scheduler<components_capacity, BitsStorageType>::Build(const std::vector<std::unique_ptr<SystemType>>& systems)
+    {
+        _nodes.clear();
+        _nodes.reserve(systems.size());
+
+        for(std::size_t i{0}; i<systems.size(); ++i)
+        {
+            _nodes.push_back({systems[i].get(), {}, {}});
+
+            for(std::size_t j{0}; j<i; ++j)
+                if(Conflict(*systems[j], *systems[i]))
+                {
+                    _nodes[i].dependencies.push_back(j);
+                    _nodes[j].dependents.push_back(i);
+                }
+        }
+
+        _remainingDependencies = std::make_unique<std::atomic<std::size_t>[]>(_nodes.size());
+        _timings.assign(_nodes.size(), {});
+        for(std::size_t i{0}; i<_nodes.size(); ++i)
+            _timings[i].system = _nodes[i].system;
+
+        _criticalPath.clear();
+    }
+
+    template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
+#ifdef MYECS_INSTRUMENTATION
+    void Scheduler<components_capacity, BitsStorageType>::Run(ThreadPool& threadPool, TraceRecorder* trace)
+#else
+    void Scheduler<components_capacity, BitsStorageType>::Run(ThreadPool& threadPool)
+#endif
+    {
+        if(_nodes.empty())
+            return;
+
+#ifdef MYECS_INSTRUMENTATION
+        _trace = trace && trace->IsRecording() ? trace : nullptr;
+#endif
+
+        for(std::size_t i{0}; i<_nodes.size(); ++i)
+            _remainingDependencies[i].store(_nodes[i].dependencies.size(), std::memory_order_relaxed);
+
+        _remainingNodes.store(_nodes.size(), std::memory_order_release);
+
+        for(std::size_t i{0}; i<_nodes.size(); ++i)
+            if(_nodes[i].dependencies.empty())
+                threadPool.Submit([this, &threadPool, i]{ RunNode(threadPool, i); });
+
+        threadPool.WaitUntil([this]{ return _remainingNodes.load(std::memory_order_acquire) == 0; });
+
+        ComputeCriticalPath();
+    }
+
+    template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
+    std::chrono::nanoseconds Scheduler<components_capacity, BitsStorageType>::GetCriticalPathDuration() const
+    {
+        return _criticalPath.empty() ? std::chrono::nanoseconds{0} : _timings[_criticalPath.back()].pathDuration;
+    }
+
+    template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
+    bool Scheduler<components_capacity, BitsStorageType>::Conflict(const SystemType& lhs, const SystemType& rhs)
+    {
+        return lhs._writeComponentsBits.IsAndNonZero(rhs._writeComponentsBits) ||
+               lhs._writeComponentsBits.IsAndNonZero(rhs._readComponentsBits) ||
+               lhs._readComponentsBits.IsAndNonZero(rhs._writeComponentsBits);
+    }
+
+    template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
+    void Scheduler<components_capacity, BitsStorageType>::RunNode(ThreadPool& threadPool, std::size_t node)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        _nodes[node].system->OnUpdate();
+        _timings[node].duration = std::chrono::steady_clock::now() - start;
+
+#ifdef MYECS_INSTRUMENTATION
+        if(_trace)
+            _trace->Record(typeid(*_nodes[node].system).name(), "system", start, _timings[node].duration);
+#endif
+
+        for(const auto dependent : _nodes[node].dependents)
+            if(_remainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                threadPool.Submit([this, &threadPool, dependent]{ RunNode(threadPool, dependent); });
+
+        _remainingNodes.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
+    void Scheduler<components_capacity, BitsStorageType>::ComputeCriticalPath()
+    {
+        std::vector<std::size_t> predecessors(_nodes.size(), _nodes.size());
+        std::size_t last{0};
+
+        for(std::size_t i{0}; i<_nodes.size(); ++i)
+        {
+            std::chrono::nanoseconds longestDependency{0};
+            for(const auto dependency : _nodes[i].dependencies)
+                if(_timings[dependency].pathDuration >= longestDependency)
+                {
+                    longestDependency = _timings[dependency].pathDuration;
+                    predecessors[i] = dependency;
+                }
+
+            _timings[i].pathDuration = longestDependency + _timings[i].duration;
+            if(_timings[i].pathDuration > _timings[last].pathDuration)
+                last = i;
+        }
+
+        _criticalPath.clear();
+        for(std::size_t i{last}; i<_nodes.size(); i = predecessors[i])
+            _criticalPath.push_back(i);
+
+        std::reverse(_criticalPath.begin(), _criticalPath.end());
+    }
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include "Snapshot.h"
+
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MYECS_SNAPSHOT_MMAP
+#endif
+
+using namespace MyECS;
+
+void SnapshotWriter::Write(const void* data, std::size_t size)
+{
+    const auto offset = _buffer.size();
+    _buffer.resize(offset + size);
+
+    if(size != 0)
+        std::memcpy(_buffer.data() + offset, data, size);
+}
+
+void SnapshotWriter::Patch(std::size_t offset, const void* data, std::size_t size)
+{
+    std::memcpy(_buffer.data() + offset, data, size);
+}
+
+bool SnapshotReader::Read(void* data, std::size_t size)
+{
+    const auto bytes = View(size);
+    if(_failed)
+        return false;
+
+    if(size != 0)
+        std::memcpy(data, bytes.data(), size);
+
+    return true;
+}
+
+bool SnapshotReader::Skip(std::size_t size)
+{
+    View(size);
+    return !_failed;
+}
+
+std::span<const std::byte> SnapshotReader::View(std::size_t size)
+{
+    if(_failed || size > Remaining())
+    {
+        _failed = true;
+        return {};
+    }
+
+    const auto bytes = _data.subspan(_offset, size);
+    _offset += size;
+
+    return bytes;
+}
+
+MappedSnapshot::MappedSnapshot(const char* path)
+{
+#ifdef MYECS_SNAPSHOT_MMAP
+    const int file = open(path, O_RDONLY);
+    if(file < 0)
+        return;
+
+    struct stat fileStat{};
+    if(fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        void* mapping = mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if(mapping != MAP_FAILED)
+        {
+            _data = static_cast<const std::byte*>(mapping);
+            _size = static_cast<std::size_t>(fileStat.st_size);
+        }
+    }
+
+    close(file);
+#else
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    if(!file)
+        return;
+
+    _fallback.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+
+    if(file.read(reinterpret_cast<char*>(_fallback.data()), static_cast<std::streamsize>(_fallback.size())))
+    {
+        _data = _fallback.data();
+        _size = _fallback.size();
+    }
+#endif
+}
+
+MappedSnapshot::~MappedSnapshot()
+{
+#ifdef MYECS_SNAPSHOT_MMAP
+    if(_data)
+        munmap(const_cast<std::byte*>(_data), _size);
+#endif
+}
+
+bool MyECS::WriteSnapshotFile(const char* path, std::span<const std::byte> snapshot)
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char*>(snapshot.data()), static_cast<std::streamsize>(snapshot.size()));
+
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,112 @@
+#ifndef MYECS_SOA_IMPL_TPP
+#define MYECS_SOA_IMPL_TPP
+
+#include <Inc/SoA.h>
+#include <algorithm>
+
+namespace MyECS
+{
+    template<typename T> requires SoAComponent<T>
+    SoARef<T>::operator Value() const
+    {
+        Value value{};
+        [&]<std::size_t ...I>(std::index_sequence<I...>){
+            ((value.*std::get<I>(SoAFields<Value>::Members) = *std::get<I>(_fields)), ...);
+        }(std::make_index_sequence<Detail::SoAFieldsCount<T>>{});
+
+        return value;
+    }
+
+    template<typename T> requires SoAComponent<T>
+    const SoARef<T>& SoARef<T>::operator=(const Value& value) const requires (!std::is_const_v<T>)
+    {
+        [&]<std::size_t ...I>(std::index_sequence<I...>){
+            ((*std::get<I>(_fields) = value.*std::get<I>(SoAFields<Value>::Members)), ...);
+        }(std::make_index_sequence<Detail::SoAFieldsCount<T>>{});
+
+        return *this;
+    }
+
+    template<typename T> requires SoAComponent<T>
+    SoARef<T> SoASpan<T>::operator[](std::size_t index) const
+    {
+        return SoARef<T>{std::apply([index](auto... field){ return Pointers{(field + index)...}; }, _fields)};
+    }
+
+    template<typename T> requires SoAComponent<T>
+    SoAVector<T>::~SoAVector()
+    {
+        std::apply([this](auto... field){
+            (_resource->deallocate(field, _capacity * sizeof(*field), Alignment), ...);
+        }, _fields);
+    }
+
+    template<typename T> requires SoAComponent<T>
+    void SoAVector<T>::reserve(std::size_t capacity)
+    {
+        if(capacity > _capacity)
+            Reallocate(capacity);
+    }
+
+    template<typename T> requires SoAComponent<T>
+    void SoAVector<T>::Reallocate(std::size_t capacity)
+    {
+        // every new array is allocated before anything is moved, so failed allocation leaves the vector as it was
+        Pointers moved{};
+        if(capacity)
+        {
+            try
+            {
+                std::apply([this, capacity](auto&... field){
+                    ((field = static_cast<std::remove_reference_t<decltype(field)>>(
+                        _resource->allocate(capacity * sizeof(*field), Alignment))), ...);
+                }, moved);
+            }
+            catch(...)
+            {
+                std::apply([this, capacity](auto... field){
+                    ((field ? _resource->deallocate(field, capacity * sizeof(*field), Alignment) : void()), ...);
+                }, moved);
+                throw;
+            }
+        }
+
+        [&]<std::size_t ...I>(std::index_sequence<I...>){
+            ([&]{
+                auto*& field = std::get<I>(_fields);
+                using Field = std::remove_pointer_t<std::remove_reference_t<decltype(field)>>;
+                static_assert(std::is_trivially_copyable_v<Field>, "members of SoA components have to be trivially copyable");
+
+                if(field)
+                {
+                    if(_size)
+                        std::memcpy(std::get<I>(moved), field, _size * sizeof(Field));
+                    _resource->deallocate(field, _capacity * sizeof(Field), Alignment);
+                }
+            }(), ...);
+        }(std::make_index_sequence<Detail::SoAFieldsCount<T>>{});
+
+        _fields = moved;
+        _capacity = capacity;
+    }
+
+    template<typename T> requires SoAComponent<T>
+    template<typename ...Args>
+    SoARef<T> SoAVector<T>::emplace_back(Args&&... args)
+    {
+        if(_size == _capacity)
+            reserve(std::max<std::size_t>(_capacity * 2, 8));
+
+        // size grows only once the instance is written, so throwing construction leaves the vector as it was
+        auto instance = (*this)[_size];
+        if constexpr(sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...))
+            instance = (args, ...);
+        else
+            instance = T(std::forward<Args>(args)...);
+
+        ++_size;
+        return instance;
+    }
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef MYECS_SPARSESET_IMPL_TPP
+#define MYECS_SPARSESET_IMPL_TPP
+
+#include <Inc/SparseSet.h>
+
+namespace MyECS
+{
+    template<std::size_t page_size> requires (std::has_single_bit(page_size))
+    bool SparseSet<page_size>::Contains(Entity entity) const
+    {
+        const Entity index = GetEntityIndex(entity);
+        const std::size_t page = index >> _pageShift;
+
+        if(page >= _sparse.size() || !_sparse[page])
+            return false;
+
+        const auto denseIndex = (*_sparse[page])[index & _pageMask];
+
+        return denseIndex != _tombstone && _dense[denseIndex] == entity;
+    }
+
+    template<std::size_t page_size> requires (std::has_single_bit(page_size))
+    std::size_t SparseSet<page_size>::IndexOf(Entity entity) const
+    {
+        const Entity index = GetEntityIndex(entity);
+
+        return (*_sparse[index >> _pageShift])[index & _pageMask];
+    }
+
+    template<std::size_t page_size> requires (std::has_single_bit(page_size))
+    std::size_t SparseSet<page_size>::Insert(Entity entity)
+    {
+        const auto index = static_cast<uint32_t>(_dense.size());
+
+        AssurePage(GetEntityIndex(entity)) = index;
+        _dense.push_back(entity);
+
+        return index;
+    }
+
+    template<std::size_t page_size> requires (std::has_single_bit(page_size))
+    std::size_t SparseSet<page_size>::Erase(Entity entity)
+    {
+        const Entity entityIndex = GetEntityIndex(entity);
+        const Entity lastIndex = GetEntityIndex(_dense.back());
+
+        auto& slot = (*_sparse[entityIndex >> _pageShift])[entityIndex & _pageMask];
+        const auto index = slot;
+
+        _dense[index] = _dense.back();
+        (*_sparse[lastIndex >> _pageShift])[lastIndex & _pageMask] = index;
+
+        slot = _tombstone;
+        _dense.pop_back();
+
+        return index;
+    }
+
+    template<std::size_t page_size> requires (std::has_single_bit(page_size))
+    void SparseSet<page_size>::Swap(std::size_t lhs, std::size_t rhs)
+    {
+        const Entity lhsIndex = GetEntityIndex(_dense[lhs]);
+        const Entity rhsIndex = GetEntityIndex(_dense[rhs]);
+
+        std::swap((*_sparse[lhsIndex >> _pageShift])[lhsIndex & _pageMask], (*_sparse[rhsIndex >> _pageShift])[rhsIndex & _pageMask]);
+        std::swap(_dense[lhs], _dense[rhs]);
+    }
+
+    template<std::size_t page_size> requires (std::has_single_bit(page_size))
+    void SparseSet<page_size>::Reserve(std::size_t count)
+    {
+        _dense.reserve(count);
+    }
+
+    template<std::size_t page_size> requires (std::has_single_bit(page_size))
+    void SparseSet<page_size>::Clear()
+    {
+        // only slots of contained entities are set, so clearing costs as much as there are entities
+        for(const auto entity : _dense)
+        {
+            const Entity entityIndex = GetEntityIndex(entity);
+            (*_sparse[entityIndex >> _pageShift])[entityIndex & _pageMask] = _tombstone;
+        }
+
+        _dense.clear();
+    }
+
+    template<std::size_t page_size> requires (std::has_single_bit(page_size))
+    void SparseSet<page_size>::ShrinkToFit()
+    {
+        _dense.shrink_to_fit();
+
+        for(auto& page : _sparse)
+            if(page && std::all_of(page->begin(), page->end(), [](uint32_t index){ return index == _tombstone; }))
+                page.reset();
+
+        while(!_sparse.empty() && !_sparse.back())
+            _sparse.pop_back();
+
+        _sparse.shrink_to_fit();
+    }
+
+    template<std::size_t page_size> requires (std::has_single_bit(page_size))
+    uint32_t& SparseSet<page_size>::AssurePage(Entity index)
+    {
+        const std::size_t page = index >> _pageShift;
+
+        if(page >= _sparse.size())
+            _sparse.resize(page + 1);
+
+        if(!_sparse[page])
+        {
+            _sparse[page] = std::make_unique<Page>();
+            _sparse[page]->fill(_tombstone);
+        }
+
+        return (*_sparse[page])[index & _pageMask];
+    }
+}
+
+#endif
@@ -10,7 +10,11 @@ namespace MyECS
     System<components_capacity, BitsStorageType>::
     System(SystemComponents<ManagedComponentsTypes...>&&)
     {
-        (_managedComponentsBits.TrySet(ID::get<ManagedComponentsTypes>()), ...);
+        (_managedComponentsBits.TrySet(ID::get<UnwrapComponent<ManagedComponentsTypes>>()), ...);
+
+        ((ComponentAccess<ManagedComponentsTypes>::ReadOnly
+            ? _readComponentsBits.TrySet(ID::get<UnwrapComponent<ManagedComponentsTypes>>())
+            : _writeComponentsBits.TrySet(ID::get<UnwrapComponent<ManagedComponentsTypes>>())), ...);
     }
 
     template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
@@ -18,16 +22,16 @@ namespace MyECS
     OnEntityUpdate(Entity entity, const Bits<BitsStorageType, components_capacity>& entityComponentsBits)
     {
         bool componentsMatch = _managedComponentsBits.DoesAndEqualThis(entityComponentsBits);
-        bool entityExists = _managedEntities.contains(entity);
+        bool entityExists = _managedEntities.Contains(entity);
 
         if(!entityExists && componentsMatch)
         {
-            _managedEntities.emplace(std::make_pair(entity, entity));
+            _managedEntities.Insert(entity);
             OnEntityAdditionAction(entity);
         }
         else if(entityExists && !componentsMatch)
         {
-            _managedEntities.erase(entity);
+            _managedEntities.Erase(entity);
             OnEntityRemovalAction(entity);
         }
     }
@@ -36,9 +40,9 @@ namespace MyECS
     void System<components_capacity, BitsStorageType>::
     OnEntityRemove(Entity entity)
     {
-        if(_managedEntities.contains(entity))
+        if(_managedEntities.Contains(entity))
         {
-            _managedEntities.erase(entity);
+            _managedEntities.Erase(entity);
             OnEntityRemovalAction(entity);
         }
     }
@@ -49,10 +53,34 @@ namespace MyECS
     {
         if(_managedComponentsBits.DoesAndEqualThis(entityComponentsBits))
         {
-            _managedEntities.emplace(std::make_pair(entity, entity));
+            _managedEntities.Insert(entity);
             OnEntityAdditionAction(entity);
         }
     }
+
+    template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
+    void System<components_capacity, BitsStorageType>::
+    OnEntitiesAdd(std::span<const Entity> entities, const Bits<BitsStorageType, components_capacity>& entitiesComponentsBits)
+    {
+        if(!_managedComponentsBits.DoesAndEqualThis(entitiesComponentsBits))
+            return;
+
+        _managedEntities.Reserve(_managedEntities.Size() + entities.size());
+        for(const auto entity : entities)
+        {
+            _managedEntities.Insert(entity);
+            OnEntityAdditionAction(entity);
+        }
+    }
+
+    template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
+    template<typename ComponentsBitsGetter>
+    void System<components_capacity, BitsStorageType>::
+    OnEntitiesUpdate(std::span<const Entity> entities, ComponentsBitsGetter&& entityComponentsBits)
+    {
+        for(const auto entity : entities)
+            OnEntityUpdate(entity, entityComponentsBits(entity));
+    }
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "ThreadPool.h"
+using namespace MyECS;
+
+thread_local ThreadPool* ThreadPool::_currentPool{nullptr};
+thread_local std::size_t ThreadPool::_currentIndex{0};
+
+ThreadPool::ThreadPool(std::size_t threadsCount)
+{
+    threadsCount = std::max<std::size_t>(threadsCount, 1);
+
+    for(std::size_t i{0}; i<threadsCount; ++i)
+        _queues.push_back(std::make_unique<Queue>());
+
+    _workers.reserve(threadsCount);
+    for(std::size_t i{0}; i<threadsCount; ++i)
+        _workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{_sleepMutex};
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+
+    for(auto& worker : _workers)
+        worker.join();
+}
+
+void ThreadPool::Submit(Task task)
+{
+    const std::size_t index = (_currentPool == this) ? _currentIndex : _nextQueue++ % _queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock{_sleepMutex};
+        ++_pendingTasks;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{_queues[index]->mutex};
+        _queues[index]->tasks.push_back(std::move(task));
+    }
+    _sleepCondition.notify_one();
+}
+
+bool ThreadPool::TryRunPendingTask()
+{
+    Task task;
+    const std::size_t index = (_currentPool == this) ? _currentIndex : 0;
+
+    if((_currentPool == this && TryPop(index, task)) || TrySteal(index, task))
+    {
+        task();
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::WorkerLoop(std::size_t index)
+{
+    _currentPool = this;
+    _currentIndex = index;
+
+    while(true)
+    {
+        Task task;
+        if(TryPop(index, task) || TrySteal(index, task))
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{_sleepMutex};
+        _sleepCondition.wait(lock, [this]{ return _stop || _pendingTasks > 0; });
+
+        if(_stop && _pendingTasks == 0)
+            return;
+    }
+}
+
+bool ThreadPool::TryPop(std::size_t index, Task& task)
+{
+    auto& queue = *_queues[index];
+    std::lock_guard<std::mutex> lock{queue.mutex};
+
+    if(queue.tasks.empty())
+        return false;
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    --_pendingTasks;
+
+    return true;
+}
+
+bool ThreadPool::TrySteal(std::size_t index, Task& task)
+{
+    for(std::size_t i{1}; i<=_queues.size(); ++i)
+    {
+        auto& queue = *_queues[(index + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+
+        if(queue.tasks.empty())
+            continue;
+
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        --_pendingTasks;
+
+        return true;
+    }
+
+    return false;
+}
@@ -2,3 +2,4 @@
 using namespace MyECS;
 
 std::atomic<std::size_t> ID::counter{0};
+std::atomic<std::size_t> SingletonID::counter{0};
@@ -0,0 +1,128 @@
+#ifndef MYECS_VIEW_IMPL_TPP
+#define MYECS_VIEW_IMPL_TPP
+
+#include <Inc/View.h>
+
+namespace MyECS
+{
+    template<typename Manager, typename ...Args>
+    View<Manager, Args...>::View(const Manager* manager)
+        : _manager(manager), _storages(Storage<Args>()...)
+    {
+        _versions.fill(0);
+    }
+
+    template<typename Manager, typename ...Args>
+    typename View<Manager, Args...>::Iterator
+    View<Manager, Args...>::begin()
+    {
+        if(IsStale()) Refresh();
+        return Iterator{this, 0};
+    }
+
+    template<typename Manager, typename ...Args>
+    typename View<Manager, Args...>::Iterator
+    View<Manager, Args...>::end()
+    {
+        if(IsStale()) Refresh();
+        return Iterator{this, _entities.size()};
+    }
+
+    template<typename Manager, typename ...Args>
+    std::size_t View<Manager, Args...>::Size()
+    {
+        return GetEntities().size();
+    }
+
+    template<typename Manager, typename ...Args>
+    const std::vector<Entity>& View<Manager, Args...>::GetEntities()
+    {
+        if(IsStale()) Refresh();
+        return _entities;
+    }
+
+    template<typename Manager, typename ...Args>
+    template<typename Fn>
+    void View<Manager, Args...>::Each(Fn&& fn)
+    {
+        for(const auto entity : GetEntities())
+            std::apply(fn, Get(entity));
+    }
+
+    template<typename Manager, typename ...Args>
+    template<typename ExecutionPolicy, typename Fn>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    void View<Manager, Args...>::Each(ExecutionPolicy&& policy, Fn&& fn)
+    {
+        const auto& entities = GetEntities();
+
+        std::for_each(std::forward<ExecutionPolicy>(policy), entities.begin(), entities.end(), [this, &fn](Entity entity){
+            std::apply(fn, Get(entity));
+        });
+    }
+
+    template<typename Manager, typename ...Args>
+    void View<Manager, Args...>::Refresh()
+    {
+        _entities.clear();
+        _valid = true;
+
+        _storages = {Storage<Args>()...};
+        if(!AllStoragesExist())
+            return;
+
+        std::size_t i{0};
+        ((_versions[i++] = Version<Args>()), ...);
+
+        // view of tags only walks alive entities
+        const std::vector<Entity>* smallest{nullptr};
+        ([&]{
+            if constexpr(!TagComponent<Args>)
+                if(!smallest || std::get<StorageType<Args>*>(_storages)->Size() < smallest->size())
+                    smallest = &std::get<StorageType<Args>*>(_storages)->GetEntities();
+        }(), ...);
+
+        if(!smallest)
+            smallest = &_manager->_aliveEntities.GetEntities();
+
+        _entities.reserve(smallest->size());
+        for(const auto entity : *smallest)
+            if((Contains<Args>(entity) && ...))
+                _entities.push_back(entity);
+    }
+
+    template<typename Manager, typename ...Args>
+    template<typename T>
+    bool View<Manager, Args...>::Contains(Entity entity) const
+    {
+        if constexpr(TagComponent<T>)
+            return _manager->_entitiesTable.GetComponents(entity).GetBitState(Manager::template ComponentId<T>());
+        else
+            return std::get<StorageType<T>*>(_storages)->Contains(entity);
+    }
+
+    template<typename Manager, typename ...Args>
+    template<typename T>
+    std::size_t View<Manager, Args...>::Version() const
+    {
+        if constexpr(TagComponent<T>)
+            return _manager->_tagsVersion.load(std::memory_order_acquire);
+        else
+            return std::get<StorageType<T>*>(_storages)->Version();
+    }
+
+    template<typename Manager, typename ...Args>
+    bool View<Manager, Args...>::IsStale() const
+    {
+        if(!_valid)
+            return true;
+
+        if(!AllStoragesExist())
+            return ((TagComponent<Args> || Storage<Args>() != nullptr) && ...);
+
+        std::size_t i{0};
+        return ((_versions[i++] != Version<Args>()) || ...);
+    }
+}
+
+#endif
@@ -3,16 +3,23 @@
 
 #include <cinttypes>
 #include <array>
+#include <bit>
+#include <cstring>
+#include <iterator>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace MyECS
 {
     template<typename T, std::size_t count> requires std::is_unsigned_v<T>
     struct Bits
     {
-        Bits() { _bits.fill(0); }
+        constexpr Bits() : _bits{} {}
 
         void TrySet(size_t bitIndex);
-        void Set(size_t bitIndex);
+        constexpr void Set(size_t bitIndex);
         void TryReset(size_t bitIndex);
         void Reset(size_t bitIndex);
         bool IsAndNonZero(const Bits<T,count>& other) const;
@@ -23,7 +30,45 @@ namespace MyECS
         bool GetBitState(size_t bitIndex) const;
         bool TryGetBitState(size_t bitIndex) const;
 
-        std::vector<uint32_t> GetOnes() const;
+        ///forward iterator over indices of set bits, skips whole zero words and finds bits with countr_zero
+        class OnesIterator
+        {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = uint32_t;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const uint32_t*;
+                using reference = uint32_t;
+
+                OnesIterator() = default;
+                OnesIterator(const T* words, std::size_t wordIndex);
+
+                uint32_t operator*() const { return static_cast<uint32_t>(_wordIndex * _typeSize + std::countr_zero(_word)); }
+
+                OnesIterator& operator++();
+                OnesIterator operator++(int) { auto result = *this; ++(*this); return result; }
+
+                bool operator==(const OnesIterator& other) const { return _wordIndex == other._wordIndex && _word == other._word; }
+
+            private:
+                void SkipZeroWords();
+
+                const T* _words{nullptr};
+                std::size_t _wordIndex{0};
+                T _word{0};
+        };
+
+        struct OnesRange
+        {
+            OnesIterator begin() const { return _begin; }
+            OnesIterator end() const { return _end; }
+
+            OnesIterator _begin;
+            OnesIterator _end;
+        };
+
+        ///indices of set bits in ascending order, e.g. for(auto id : mask.Ones())
+        OnesRange Ones() const;
 
         Bits& operator|=(const Bits<T, count>& other);
         Bits& operator&=(const Bits<T, count>& other);
@@ -32,25 +77,27 @@ namespace MyECS
             static constexpr uint8_t _typeSize = sizeof(T) * 8;
             static constexpr std::size_t _trueCount = ((count / _typeSize) + ((count % _typeSize == 0) ? 0 : 1));
 
+            static constexpr std::size_t _bytesCount = sizeof(T) * _trueCount;
+
+            ///vector backend is picked when words fill whole registers, otherwise loops go word by word,
+            ///whole words are used so operations never touch bytes past the array
+        #ifdef __AVX2__
+            static constexpr std::size_t _vectorSize = (_bytesCount % 32 == 0) ? 32 : (_bytesCount % 16 == 0) ? 16 : 0;
+        #elif defined(__SSE2__)
+            static constexpr std::size_t _vectorSize = (_bytesCount % 16 == 0) ? 16 : 0;
+        #else
+            static constexpr std::size_t _vectorSize = 0;
+        #endif
+
             std::array<T, _trueCount> _bits;
 
             static constexpr T _moduloMask = _typeSize - static_cast<T>(1);
-            static constexpr T _divideShift = std::log2p1(_typeSize) - static_cast<T>(1);
+            static constexpr T _divideShift = std::bit_width(_typeSize) - static_cast<T>(1);
             static constexpr T _setMask = static_cast<T>(1);
-            static constexpr auto _compiledSequence = std::make_integer_sequence<uint8_t, _typeSize>();
-
-            ///function retrieves and adds indices of set bits to result vector it is helper function for
-            ///function "std::vector<uint32_t> GetOnes() const;"
-            template<typename size_type = std::size_t, size_type ...Indices>
-            void GetSetBitsOnType(std::integer_sequence<size_type, Indices...>, T varFromBitset,
-                                 std::vector<uint32_t>& result, uint32_t offset) const;
 
             friend bool operator==(const Bits<T, count>& lhs, const Bits<T, count>& rhs)
             {
-                for(std::size_t i{0}; i<lhs._bits.size(); ++i)
-                    if(lhs._bits[i] != rhs._bits[i]) return false;
-
-                return true;
+                return std::memcmp(lhs._bits.data(), rhs._bits.data(), _bytesCount) == 0;
             }
     };
 
@@ -0,0 +1,82 @@
+#ifndef MYECS_CHANGETRACKER_H
+#define MYECS_CHANGETRACKER_H
+
+#include <Inc/Entity.h>
+#include <algorithm>
+#include <span>
+#include <vector>
+
+namespace MyECS
+{
+    ///manager's change clock, every change is stamped with the tick current at the time it was made
+    using ChangeTick = uint64_t;
+
+    struct ComponentChange
+    {
+        Entity entity;
+        uint32_t componentId;
+
+        bool operator==(const ComponentChange&) const = default;
+    };
+
+    ///components changed (added or marked) and removed after some tick
+    struct ChangeSet
+    {
+        std::vector<ComponentChange> changed;
+        std::vector<ComponentChange> removed;
+    };
+
+    ///change ticks of dense slots of one storage, kept in step with its dense arrays (swap-and-pop included),
+    ///every block of slots keeps the newest tick of its slots, so collecting skips blocks without changes,
+    ///removed components are logged until discarded
+    class ChangeTracker
+    {
+        public:
+            ///starts stamping slots with *clock, all present slots count as changed now
+            void Enable(const ChangeTick* clock, std::size_t size);
+            bool Enabled() const { return _clock != nullptr; }
+
+            void OnAdd(std::size_t count = 1);
+
+            ///denseIndex is the index erased entity occupied, last slot is moved to it
+            void OnErase(std::size_t denseIndex, Entity);
+
+            void Mark(std::size_t denseIndex)
+            {
+                _ticks[denseIndex] = *_clock;
+                _blockTicks[denseIndex / _blockSize] = *_clock;
+            }
+
+            void MarkAll();
+
+            ///exchanges ticks of two slots when their instances swap places
+            void Swap(std::size_t lhs, std::size_t rhs);
+
+            void ShrinkToFit();
+
+            ///size slots which all count as changed now, removals log is kept
+            void Reset(std::size_t size);
+
+            ///appends changes newer than since, entities are the dense entities of the storage
+            void Collect(ChangeTick since, std::span<const Entity> entities, uint32_t componentId, ChangeSet&) const;
+
+            ///forgets removals made up to until (inclusive)
+            void DiscardRemovals(ChangeTick until);
+
+            std::size_t MemoryUsage() const
+            {
+                return (_ticks.capacity() + _blockTicks.capacity()) * sizeof(ChangeTick) +
+                       _removals.capacity() * sizeof(std::pair<Entity, ChangeTick>);
+            }
+
+        private:
+            static constexpr std::size_t _blockSize = 64;
+
+            const ChangeTick* _clock{nullptr};
+            std::vector<ChangeTick> _ticks;
+            std::vector<ChangeTick> _blockTicks;
+            std::vector<std::pair<Entity, ChangeTick>> _removals;
+    };
+}
+
+#endif
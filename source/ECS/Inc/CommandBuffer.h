@@ -0,0 +1,88 @@
+#ifndef MYECS_COMMANDBUFFER_H
+#define MYECS_COMMANDBUFFER_H
+
+#include <Inc/Entity.h>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace MyECS
+{
+    ///records structural changes (create/add/detach/remove) into a byte stream without touching the manager,
+    ///so every worker can fill its own buffer without locks, changes are applied by Manager::Flush in recording order,
+    ///stream is made of blocks which never move, recorded components are constructed in place in them
+    template<typename Manager>
+    class CommandBuffer
+    {
+        friend Manager;
+
+        public:
+            static constexpr Entity ProvisionalEntityFlag = Entity{1} << (sizeof(Entity) * 8 - 1);
+
+            CommandBuffer() = default;
+            ~CommandBuffer();
+
+            CommandBuffer(const CommandBuffer&) = delete;
+            CommandBuffer& operator=(const CommandBuffer&) = delete;
+            CommandBuffer(CommandBuffer&&) noexcept = default;
+            CommandBuffer& operator=(CommandBuffer&&) noexcept = default;
+
+            ///returns provisional entity which can be used by following commands of this buffer,
+            ///it is replaced by the real entity on flush
+            template<bool ThreadSafeComponents = false, typename ...Args>
+            Entity CreateEntity(Args&&... components);
+
+            ///components the entity has by the time of flush are assigned (the last flushed command wins)
+            template<bool ThreadSafeComponents = false, typename ...Args>
+            void AddComponents(Entity, Args&&... components);
+
+            ///components the entity lacks by the time of flush are skipped
+            template<typename ...Args>
+            void DetachComponents(Entity);
+
+            void RemoveEntity(Entity);
+
+            bool Empty() const { return _commandsCount == 0; }
+
+            ///destroys not applied commands, blocks are kept for reuse
+            void Clear();
+
+        private:
+            enum class CommandType : uint8_t { Create, Modify, Remove };
+
+            struct Command
+            {
+                void(*apply)(Manager&, Entity, std::byte* payload);
+                void(*destroy)(std::byte* payload);
+                Entity entity;
+                CommandType type;
+                uint32_t payloadOffset;
+                uint32_t next;
+            };
+
+            struct Block
+            {
+                std::unique_ptr<std::byte[]> data;
+                std::size_t capacity;
+                std::size_t used;
+            };
+
+            static constexpr std::size_t _blockSize = 16 * 1024;
+
+            ///reserves space for command followed by payload, returns pointer to payload
+            std::byte* Record(CommandType, Entity, void(*apply)(Manager&, Entity, std::byte*),
+                              void(*destroy)(std::byte*), std::size_t payloadSize, std::size_t payloadAlignment);
+
+            template<typename Fn>
+            void ForEachCommand(Fn&& fn);
+
+            std::vector<Block> _blocks;
+            std::size_t _currentBlock{0};
+            std::size_t _commandsCount{0};
+            Entity _provisionalCount{0};
+    };
+}
+
+#include "Impl/CommandBuffer_impl.tpp"
+
+#endif
@@ -1,13 +1,24 @@
 #ifndef MYECS_COMPONENTMANAGER_H
 #define MYECS_COMPONENTMANAGER_H
 
-#include <unordered_map>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <algorithm>
+#include <span>
 #include <Inc/Entity.h>
 #include <Inc/Bits.h>
+#include <Inc/SparseSet.h>
 #include <Inc/TypeIdGenerator.h>
+#include <Inc/Snapshot.h>
+#include <Inc/ChangeTracker.h>
+#include <Inc/SoA.h>
+#ifdef MYECS_INSTRUMENTATION
+#include <Inc/Instrumentation.h>
+#endif
 #include <mutex>
+#include <shared_mutex>
+#include <utility>
 
 namespace MyECS
 {
@@ -27,52 +38,217 @@ namespace MyECS
     #endif
 
 
+    ///empty components are tags, the component bit of the entity is all they need, so they get no storage
+    template<typename T>
+    concept TagComponent = std::is_empty_v<T>;
+
     template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
     class BaseComponentsStorage
     {
         public:
+            virtual ~BaseComponentsStorage() = default;
+
             virtual void DeleteComponentInstance(Entity) = 0;
             virtual const Bits<BitsStorageType, components_capacity>& GetBits() const = 0;
+
+            ///writes entities and instances as snapshot storage record, false if component can't be written
+            virtual bool Save(SnapshotWriter&, uint32_t componentId) const = 0;
+
+            ///replaces all instances with the ones of the record, reader stands after record header
+            virtual bool Load(SnapshotReader&, const SnapshotStorageHeader&) = 0;
+
+            virtual void Clear() = 0;
+
+            ///stamps instance of entity with current change tick, no-op if storage doesn't track changes
+            virtual void MarkChanged(Entity) = 0;
+            virtual void MarkAllChanged() = 0;
+
+            ///appends (entity, componentId) pairs changed or removed after since
+            virtual void CollectChanges(ChangeTick since, uint32_t componentId, ChangeSet&) const = 0;
+
+            ///drops removals logged up to until
+            virtual void DiscardChanges(ChangeTick until) = 0;
+
+            ///replaces entities with entities of the instances in dense order
+            virtual void CopyEntities(std::vector<Entity>& entities) const = 0;
+
+            ///moves instances of stored entities of order to consecutive dense indices from position on (entities
+            ///which aren't stored are skipped), returns the index following the last moved instance
+            virtual std::size_t Arrange(std::span<const Entity> order, std::size_t position) = 0;
+
+            ///gives back memory of dense arrays when at most half of their capacity is used
+            virtual void Shrink() = 0;
+
+#ifdef MYECS_INSTRUMENTATION
+            virtual StorageStats GetStats(std::size_t componentId) const = 0;
+#endif
     };
 
+    namespace Detail
+    {
+        template<typename T>
+        constexpr std::size_t InstanceBytes()
+        {
+            if constexpr(SoAComponent<T>)
+                return SoAVector<T>::ElementSize;
+            else
+                return sizeof(T);
+        }
+
+        ///swaps instances at dense indices lhs and rhs together with their entities and change ticks
+        template<typename T, typename Instances>
+        void SwapInstances(std::size_t lhs, std::size_t rhs, SparseSet<>& entities, Instances& instances, ChangeTracker& changes)
+        {
+            if constexpr(SoAComponent<T>)
+            {
+                const T instance = instances[lhs];
+                instances[lhs] = instances[rhs];
+                instances[rhs] = instance;
+            }
+            else
+            {
+                using std::swap;
+                swap(instances[lhs], instances[rhs]);
+            }
+
+            entities.Swap(lhs, rhs);
+            if(changes.Enabled())
+                changes.Swap(lhs, rhs);
+        }
+
+        template<typename T, typename Instances>
+        std::size_t ArrangeInstances(std::span<const Entity> order, std::size_t position,
+                                     SparseSet<>& entities, Instances& instances, ChangeTracker& changes)
+        {
+            for(const auto entity : order)
+            {
+                if(position >= instances.size())
+                    break;
+
+                if(!entities.Contains(entity))
+                    continue;
+
+                const auto index = entities.IndexOf(entity);
+                if(index != position)
+                    SwapInstances<T>(index, position, entities, instances, changes);
+
+                ++position;
+            }
+
+            return position;
+        }
+
+        ///inserts entity and appends its instance with emplace(), entity is taken out again when emplace throws
+        ///so the sparse set and dense instances stay in step (entity is inserted first as page allocation may throw too)
+        template<typename Emplace>
+        void InsertInstance(SparseSet<>& entities, Entity entity, Emplace&& emplace)
+        {
+            entities.Insert(entity);
+            try
+            {
+                emplace();
+            }
+            catch(...)
+            {
+                entities.Erase(entity);
+                throw;
+            }
+        }
+
+        template<typename Instances>
+        void ShrinkInstances(SparseSet<>& entities, Instances& instances, ChangeTracker& changes)
+        {
+            if(instances.size() > instances.capacity() / 2)
+                return;
+
+            instances.shrink_to_fit();
+            entities.ShrinkToFit();
+            changes.ShrinkToFit();
+        }
+    }
+
     template<size_t components_capacity, typename BitsStorageType, typename T, bool ThreadSafeStorage>
     requires std::is_unsigned_v<BitsStorageType>
     class ComponentsStorage : public BaseComponentsStorage<components_capacity, BitsStorageType>{};
 
 
     template<size_t components_capacity, typename BitsStorageType, typename T>
-    class ComponentsStorage<components_capacity, BitsStorageType, T, true> : public BaseComponentsStorage<components_capacity, BitsStorageType>
+    class ComponentsStorage<components_capacity, BitsStorageType, T, true> final : public BaseComponentsStorage<components_capacity, BitsStorageType>
     {
-        template<size_t, size_t, typename BitsStorageType_> requires std::is_unsigned_v<BitsStorageType_>
+        template<size_t, size_t, typename BitsStorageType_, typename> requires std::is_unsigned_v<BitsStorageType_>
         friend class EntityManager;
 
+        using WriteLock = std::unique_lock<std::shared_mutex>;
+        using ReadLock = std::shared_lock<std::shared_mutex>;
+
         public:
-            ComponentsStorage()
+            ComponentsStorage() : ComponentsStorage(std::pmr::get_default_resource()) {}
+
+            ///instances are allocated from resource, pmr-aware components get it through uses-allocator construction
+            explicit ComponentsStorage(std::pmr::memory_resource* resource)
+                : _componentInstances(resource)
             {
                 _componentBits.Set(ID::get<T>());
             }
 
             void DeleteComponentInstance(Entity entity) override
             {
-                std::lock_guard<std::mutex> lock{_mutex};
-
-                _componentInstances[_entityToComponentIndex[entity]] = std::move(_componentInstances.back());
-
-                _entityToComponentIndex[_componentIndexToEntity[_componentInstances.size() - 1]] = _entityToComponentIndex[entity];
-                _componentIndexToEntity[_entityToComponentIndex[entity]] = _componentIndexToEntity[_componentInstances.size() - 1];
+                const auto lock = LockWrite();
 
-                _entityToComponentIndex.erase(entity);
-                _componentIndexToEntity.erase(_componentInstances.size() - 1);
+                const auto index = _entities.Erase(entity);
+                if(index != _componentInstances.size() - 1)
+                    _componentInstances[index] = std::move(_componentInstances.back());
 
                 _componentInstances.pop_back();
+                if(_changes.Enabled())
+                    _changes.OnErase(index, entity);
             }
 
             void AddComponentInstance(Entity entity, T&& instance)
             {
-                std::lock_guard<std::mutex> lock{_mutex};
-                _entityToComponentIndex[entity] = _componentInstances.size();
-                _componentIndexToEntity[_componentInstances.size()] = entity;
-                _componentInstances.emplace_back(instance);
+                EmplaceComponentInstance(entity, std::move(instance));
+            }
+
+            ///constructs instance directly in the dense array
+            template<typename ...CtorArgs>
+            void EmplaceComponentInstance(Entity entity, CtorArgs&&... args)
+            {
+                const auto lock = LockWrite();
+                Detail::InsertInstance(_entities, entity, [&]{ _componentInstances.emplace_back(std::forward<CtorArgs>(args)...); });
+                if(_changes.Enabled())
+                    _changes.OnAdd();
+            }
+
+            ///makes room for count instances in total
+            void Reserve(std::size_t count)
+            {
+                const auto lock = LockWrite();
+                ReserveAdditional(count > _componentInstances.size() ? count - _componentInstances.size() : 0);
+            }
+
+            ///appends makeInstance(i) for every entities[i] under one lock, dense arrays grow at most once
+            template<typename Fn>
+            void AddComponentInstances(std::span<const Entity> entities, Fn&& makeInstance)
+            {
+                const auto lock = LockWrite();
+                ReserveAdditional(entities.size());
+
+                // instances added before makeInstance threw stay, change ticks are kept in step with them
+                std::size_t added{0};
+                try
+                {
+                    for(; added<entities.size(); ++added)
+                        Detail::InsertInstance(_entities, entities[added], [&]{ _componentInstances.emplace_back(makeInstance(added)); });
+                }
+                catch(...)
+                {
+                    if(_changes.Enabled())
+                        _changes.OnAdd(added);
+                    throw;
+                }
+
+                if(_changes.Enabled())
+                    _changes.OnAdd(entities.size());
             }
 
             const Bits<BitsStorageType, components_capacity>& GetBits() const override
@@ -80,59 +256,286 @@ namespace MyECS
                 return _componentBits;
             }
 
+            bool Save(SnapshotWriter& writer, uint32_t componentId) const override
+            {
+                const auto lock = LockRead();
+                return Detail::SaveStorage<T>(writer, componentId, _entities, _componentInstances);
+            }
+
+            bool Load(SnapshotReader& reader, const SnapshotStorageHeader& header) override
+            {
+                const auto lock = LockWrite();
+                const bool loaded = Detail::LoadStorage<T>(reader, header, _entities, _componentInstances);
+                if(_changes.Enabled())
+                    _changes.Reset(_componentInstances.size());
+
+                return loaded;
+            }
+
+            void Clear() override
+            {
+                const auto lock = LockWrite();
+                _entities.Clear();
+                _componentInstances.clear();
+                if(_changes.Enabled())
+                    _changes.Reset(0);
+            }
+
+            void MarkChanged(Entity entity) override
+            {
+                const auto lock = LockWrite();
+                if(_changes.Enabled())
+                    _changes.Mark(_entities.IndexOf(entity));
+            }
+
+            void MarkAllChanged() override
+            {
+                const auto lock = LockWrite();
+                if(_changes.Enabled())
+                    _changes.MarkAll();
+            }
+
+            void CollectChanges(ChangeTick since, uint32_t componentId, ChangeSet& changes) const override
+            {
+                const auto lock = LockRead();
+                if(_changes.Enabled())
+                    _changes.Collect(since, _entities.GetEntities(), componentId, changes);
+            }
+
+            void DiscardChanges(ChangeTick until) override
+            {
+                const auto lock = LockWrite();
+                if(_changes.Enabled())
+                    _changes.DiscardRemovals(until);
+            }
+
+            void CopyEntities(std::vector<Entity>& entities) const override
+            {
+                const auto lock = LockRead();
+                entities = _entities.GetEntities();
+            }
+
+            std::size_t Arrange(std::span<const Entity> order, std::size_t position) override
+            {
+                const auto lock = LockWrite();
+                return Detail::ArrangeInstances<T>(order, position, _entities, _componentInstances, _changes);
+            }
+
+            void Shrink() override
+            {
+                const auto lock = LockWrite();
+                Detail::ShrinkInstances(_entities, _componentInstances, _changes);
+            }
+
+            ///starts stamping instances with *clock, present instances count as changed
+            void EnableChangeTracking(const ChangeTick* clock)
+            {
+                const auto lock = LockWrite();
+                if(!_changes.Enabled())
+                    _changes.Enable(clock, _componentInstances.size());
+            }
+
+            bool Contains(Entity entity) const
+            {
+                const auto lock = LockRead();
+                return _entities.Contains(entity);
+            }
+
+            std::size_t Size() const
+            {
+                const auto lock = LockRead();
+                return _entities.Size();
+            }
+
+            ///calls fn(const T&) while holding shared lock, any number of readers run concurrently
+            template<typename Fn>
+            decltype(auto) Read(Entity entity, Fn&& fn) const
+            {
+                const auto lock = LockRead();
+                return fn(std::as_const(_componentInstances)[_entities.IndexOf(entity)]);
+            }
+
+            ///calls fn(T&) while holding exclusive lock
+            template<typename Fn>
+            decltype(auto) Write(Entity entity, Fn&& fn)
+            {
+                const auto lock = LockWrite();
+                const auto index = _entities.IndexOf(entity);
+                if(_changes.Enabled())
+                    _changes.Mark(index);
+
+                return fn(_componentInstances[index]);
+            }
+
+            ///copy of dense entities, writers may reorder them as soon as the lock is released
+            std::vector<Entity> GetEntities() const
+            {
+                const auto lock = LockRead();
+                return _entities.GetEntities();
+            }
+
+            ///instance in place, writers may move it as soon as the lock is released, so it's valid only while the storage
+            ///isn't written, Read/Write keep the lock for as long as the instance is accessed
 #ifdef DEBUG_MyECS
-            const T* GetByEntity(Entity entity) const
+            auto GetByEntity(Entity entity) const
             {
-                std::lock_guard<std::mutex> lock{_mutex};
-                return &_componentInstances[_entityToComponentIndex.at(entity)];
+                const auto lock = LockRead();
+                if constexpr(SoAComponent<T>)
+                    return _componentInstances[_entities.IndexOf(entity)];
+                else
+                    return &_componentInstances[_entities.IndexOf(entity)];
             }
 #else
-            const T& GetByEntity(Entity entity) const
+            ComponentRef<const T> GetByEntity(Entity entity) const
             {
-                std::lock_guard<std::mutex> lock{_mutex};
-                return _componentInstances[_entityToComponentIndex.at(entity)];
+                const auto lock = LockRead();
+                return _componentInstances[_entities.IndexOf(entity)];
+            }
+#endif
+
+            ///copy of the instance taken under the lock, stays valid while writers run but copies the whole component
+            T GetCopyByEntity(Entity entity) const
+            {
+                const auto lock = LockRead();
+                return _componentInstances[_entities.IndexOf(entity)];
+            }
+
+#ifdef MYECS_INSTRUMENTATION
+            StorageStats GetStats(std::size_t componentId) const override
+            {
+                const auto lock = LockRead();
+                return {componentId, sizeof(T), true, _componentInstances.size(), _componentInstances.capacity(),
+                        _componentInstances.capacity() * Detail::InstanceBytes<T>(), _entities.MemoryUsage(),
+                        _changes.MemoryUsage(), _contendedLocks.load(std::memory_order_relaxed)};
             }
 #endif
 
         private:
-            mutable std::mutex _mutex;
+            void ReserveAdditional(std::size_t count)
+            {
+                const std::size_t required = _componentInstances.size() + count;
+                if(required > _componentInstances.capacity())
+                {
+                    const std::size_t capacity = std::max(required, _componentInstances.capacity() * 2);
+                    _componentInstances.reserve(capacity);
+                    _entities.Reserve(capacity);
+                }
+            }
+
+#ifdef MYECS_INSTRUMENTATION
+            // lock is tried first so waiting for another thread can be counted
+            WriteLock LockWrite() const
+            {
+                WriteLock lock{_mutex, std::try_to_lock};
+                if(!lock.owns_lock())
+                {
+                    _contendedLocks.fetch_add(1, std::memory_order_relaxed);
+                    lock.lock();
+                }
+
+                return lock;
+            }
+
+            ReadLock LockRead() const
+            {
+                ReadLock lock{_mutex, std::try_to_lock};
+                if(!lock.owns_lock())
+                {
+                    _contendedLocks.fetch_add(1, std::memory_order_relaxed);
+                    lock.lock();
+                }
+
+                return lock;
+            }
+
+            mutable std::atomic<uint64_t> _contendedLocks{0};
+#else
+            WriteLock LockWrite() const { return WriteLock{_mutex}; }
+            ReadLock LockRead() const { return ReadLock{_mutex}; }
+#endif
+
+            mutable std::shared_mutex _mutex;
 
             Bits<BitsStorageType, components_capacity> _componentBits;
-            std::unordered_map<Entity, std::size_t> _entityToComponentIndex;
-            std::unordered_map<std::size_t, Entity> _componentIndexToEntity;
-            std::vector<T> _componentInstances;
+            SparseSet<> _entities;
+            ComponentInstances<T> _componentInstances;
+            ChangeTracker _changes;
     };
 
     template<size_t components_capacity, typename BitsStorageType, typename T>
-    class ComponentsStorage<components_capacity, BitsStorageType, T, false> : public BaseComponentsStorage<components_capacity, BitsStorageType>
+    class ComponentsStorage<components_capacity, BitsStorageType, T, false> final : public BaseComponentsStorage<components_capacity, BitsStorageType>
     {
-        template<size_t, size_t, typename BitsStorageType_> requires std::is_unsigned_v<BitsStorageType_>
+        template<size_t, size_t, typename BitsStorageType_, typename> requires std::is_unsigned_v<BitsStorageType_>
         friend class EntityManager;
 
         public:
-            ComponentsStorage()
+            ComponentsStorage() : ComponentsStorage(std::pmr::get_default_resource()) {}
+
+            ///instances are allocated from resource, pmr-aware components get it through uses-allocator construction
+            explicit ComponentsStorage(std::pmr::memory_resource* resource)
+                : _componentInstances(resource)
             {
                 _componentBits.Set(ID::get<T>());
             }
 
             void DeleteComponentInstance(Entity entity) override
             {
-                _componentInstances[_entityToComponentIndex[entity]] = std::move(_componentInstances.back());
-
-                _entityToComponentIndex[_componentIndexToEntity[_componentInstances.size() - 1]] = _entityToComponentIndex[entity];
-                _componentIndexToEntity[_entityToComponentIndex[entity]] = _componentIndexToEntity[_componentInstances.size() - 1];
-
-                _entityToComponentIndex.erase(entity);
-                _componentIndexToEntity.erase(_componentInstances.size() - 1);
+                ++_version;
+                const auto index = _entities.Erase(entity);
+                if(index != _componentInstances.size() - 1)
+                    _componentInstances[index] = std::move(_componentInstances.back());
 
                 _componentInstances.pop_back();
+                if(_changes.Enabled())
+                    _changes.OnErase(index, entity);
             }
 
             void AddComponentInstance(Entity entity, T&& instance)
             {
-                _entityToComponentIndex[entity] = _componentInstances.size();
-                _componentIndexToEntity[_componentInstances.size()] = entity;
-                _componentInstances.emplace_back(instance);
+                EmplaceComponentInstance(entity, std::move(instance));
+            }
+
+            ///constructs instance directly in the dense array
+            template<typename ...CtorArgs>
+            ComponentRef<T> EmplaceComponentInstance(Entity entity, CtorArgs&&... args)
+            {
+                ++_version;
+                Detail::InsertInstance(_entities, entity, [&]{ _componentInstances.emplace_back(std::forward<CtorArgs>(args)...); });
+                if(_changes.Enabled())
+                    _changes.OnAdd();
+
+                return _componentInstances.back();
+            }
+
+            ///makes room for count instances in total
+            void Reserve(std::size_t count)
+            {
+                ReserveAdditional(count > _componentInstances.size() ? count - _componentInstances.size() : 0);
+            }
+
+            ///appends makeInstance(i) for every entities[i], dense arrays grow at most once
+            template<typename Fn>
+            void AddComponentInstances(std::span<const Entity> entities, Fn&& makeInstance)
+            {
+                ++_version;
+                ReserveAdditional(entities.size());
+
+                // instances added before makeInstance threw stay, change ticks are kept in step with them
+                std::size_t added{0};
+                try
+                {
+                    for(; added<entities.size(); ++added)
+                        Detail::InsertInstance(_entities, entities[added], [&]{ _componentInstances.emplace_back(makeInstance(added)); });
+                }
+                catch(...)
+                {
+                    if(_changes.Enabled())
+                        _changes.OnAdd(added);
+                    throw;
+                }
+
+                if(_changes.Enabled())
+                    _changes.OnAdd(entities.size());
             }
 
             const Bits<BitsStorageType, components_capacity>& GetBits() const override
@@ -140,35 +543,150 @@ namespace MyECS
                 return _componentBits;
             }
 
+            bool Save(SnapshotWriter& writer, uint32_t componentId) const override
+            {
+                return Detail::SaveStorage<T>(writer, componentId, _entities, _componentInstances);
+            }
+
+            bool Load(SnapshotReader& reader, const SnapshotStorageHeader& header) override
+            {
+                ++_version;
+                const bool loaded = Detail::LoadStorage<T>(reader, header, _entities, _componentInstances);
+                if(_changes.Enabled())
+                    _changes.Reset(_componentInstances.size());
+
+                return loaded;
+            }
+
+            void Clear() override
+            {
+                ++_version;
+                _entities.Clear();
+                _componentInstances.clear();
+                if(_changes.Enabled())
+                    _changes.Reset(0);
+            }
+
+            void MarkChanged(Entity entity) override
+            {
+                if(_changes.Enabled())
+                    _changes.Mark(_entities.IndexOf(entity));
+            }
+
+            void MarkAllChanged() override
+            {
+                if(_changes.Enabled())
+                    _changes.MarkAll();
+            }
+
+            void CollectChanges(ChangeTick since, uint32_t componentId, ChangeSet& changes) const override
+            {
+                if(_changes.Enabled())
+                    _changes.Collect(since, _entities.GetEntities(), componentId, changes);
+            }
+
+            void DiscardChanges(ChangeTick until) override
+            {
+                if(_changes.Enabled())
+                    _changes.DiscardRemovals(until);
+            }
+
+            void CopyEntities(std::vector<Entity>& entities) const override
+            {
+                entities = _entities.GetEntities();
+            }
+
+            std::size_t Arrange(std::span<const Entity> order, std::size_t position) override
+            {
+                ++_version;
+                return Detail::ArrangeInstances<T>(order, position, _entities, _componentInstances, _changes);
+            }
+
+            void Shrink() override
+            {
+                Detail::ShrinkInstances(_entities, _componentInstances, _changes);
+            }
+
+            ///starts stamping instances with *clock, present instances count as changed
+            void EnableChangeTracking(const ChangeTick* clock)
+            {
+                if(!_changes.Enabled())
+                    _changes.Enable(clock, _componentInstances.size());
+            }
+
+            bool Contains(Entity entity) const { return _entities.Contains(entity); }
+            std::size_t Size() const { return _entities.Size(); }
+            const std::vector<Entity>& GetEntities() const { return _entities.GetEntities(); }
+
+            ///dense index of the instance of stored entity
+            std::size_t IndexOf(Entity entity) const { return _entities.IndexOf(entity); }
+
+            ///swaps instances at dense indices lhs and rhs together with their entities
+            void Swap(std::size_t lhs, std::size_t rhs)
+            {
+                ++_version;
+                Detail::SwapInstances<T>(lhs, rhs, _entities, _componentInstances, _changes);
+            }
+
+            ///incremented on every addition, removal and rearrangement, lets views detect that their cached entities are stale
+            std::size_t Version() const { return _version; }
+
 #ifdef DEBUG_MyECS
-            T* GetByEntity(Entity entity)
+            auto GetByEntity(Entity entity)
             {
                 std::lock_guard<std::mutex> lock{_mutex};
-                return &_componentInstances[_entityToComponentIndex.at(entity)];
+                if constexpr(SoAComponent<T>)
+                    return _componentInstances[_entities.IndexOf(entity)];
+                else
+                    return &_componentInstances[_entities.IndexOf(entity)];
             }
 
-            const T* GetByEntity(Entity entity) const
+            auto GetByEntity(Entity entity) const
             {
                 std::lock_guard<std::mutex> lock{_mutex};
-                return &_componentInstances[_entityToComponentIndex.at(entity)];
+                if constexpr(SoAComponent<T>)
+                    return _componentInstances[_entities.IndexOf(entity)];
+                else
+                    return &_componentInstances[_entities.IndexOf(entity)];
             }
 #else
-            T& GetByEntity(Entity entity)
+            ComponentRef<T> GetByEntity(Entity entity)
             {
-                return _componentInstances[_entityToComponentIndex.at(entity)];
+                return _componentInstances[_entities.IndexOf(entity)];
             }
 
-            const T& GetByEntity(Entity entity) const
+            ComponentRef<const T> GetByEntity(Entity entity) const
             {
-                return _componentInstances[_entityToComponentIndex.at(entity)];
+                return _componentInstances[_entities.IndexOf(entity)];
+            }
+#endif
+
+#ifdef MYECS_INSTRUMENTATION
+            StorageStats GetStats(std::size_t componentId) const override
+            {
+                return {componentId, sizeof(T), false, _componentInstances.size(), _componentInstances.capacity(),
+                        _componentInstances.capacity() * Detail::InstanceBytes<T>(), _entities.MemoryUsage(),
+                        _changes.MemoryUsage(), 0};
             }
 #endif
 
         private:
+            void ReserveAdditional(std::size_t count)
+            {
+                const std::size_t required = _componentInstances.size() + count;
+                if(required > _componentInstances.capacity())
+                {
+                    const std::size_t capacity = std::max(required, _componentInstances.capacity() * 2);
+                    _componentInstances.reserve(capacity);
+                    _entities.Reserve(capacity);
+                }
+            }
+
             Bits<BitsStorageType, components_capacity> _componentBits;
-            std::unordered_map<Entity, std::size_t> _entityToComponentIndex;
-            std::unordered_map<std::size_t, Entity> _componentIndexToEntity;
-            std::vector<T> _componentInstances;
+            SparseSet<> _entities;
+            ComponentInstances<T> _componentInstances;
+            ChangeTracker _changes;
+            std::size_t _version{0};
     };
 
 }
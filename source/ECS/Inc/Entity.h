@@ -5,8 +5,28 @@
 
 namespace MyECS
 {
+    ///entity handle packs slot index (low bits) and generation of the slot (high bits), generation is bumped
+    ///every time slot is freed so stale handles don't alias entities which reuse the slot,
+    ///top bit is never set in handles of real entities (command buffers use it for provisional entities)
     using Entity = uint32_t;
     constexpr Entity InvalidEntity = UINT32_MAX;
+
+    constexpr uint32_t EntityIndexBits = 20;
+    constexpr uint32_t EntityGenerationBits = 11;
+
+    constexpr Entity EntityIndexMask = (Entity{1} << EntityIndexBits) - 1;
+    constexpr Entity EntityGenerationMask = (Entity{1} << EntityGenerationBits) - 1;
+
+    ///count of slots addressable by entity index
+    constexpr std::size_t MaxEntitiesCount = std::size_t{EntityIndexMask} + 1;
+
+    constexpr Entity GetEntityIndex(Entity entity) { return entity & EntityIndexMask; }
+    constexpr Entity GetEntityGeneration(Entity entity) { return (entity >> EntityIndexBits) & EntityGenerationMask; }
+
+    constexpr Entity MakeEntity(Entity index, Entity generation)
+    {
+        return ((generation & EntityGenerationMask) << EntityIndexBits) | (index & EntityIndexMask);
+    }
 }
 
 #endif
@@ -3,17 +3,28 @@
 
 #include <Inc/ComponentStorage.h>
 #include <Inc/System.h>
-#include <future>
-#include <deque>
+#include <Inc/View.h>
+#include <Inc/Scheduler.h>
+#include <Inc/CommandBuffer.h>
+#include <Inc/Registry.h>
+#include <Inc/EntityTable.h>
+#include <Inc/Singletons.h>
+#include <Inc/Observers.h>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <span>
 
 namespace MyECS
 {
 #ifdef DEBUG_MyECS
     template<typename T>
-    using ComponentsReturnType = std::optional<std::vector<T>*>;
+    using ComponentsReturnType = std::optional<ComponentInstances<T>*>;
 
     template<typename T>
-    using ComponentsReturnType_const = std::optional<const std::vector<T>*>;
+    using ComponentsReturnType_const = std::optional<const ComponentInstances<T>*>;
 
     template<typename ...Args>
     using EntityComponentsReturnType = std::optional<std::tuple<Args*...>>;
@@ -22,35 +33,88 @@ namespace MyECS
     using EntityComponentsReturnType_const = std::optional<std::tuple<const Args*...>>;
 #else
     template<typename T>
-    using ComponentsReturnType = std::vector<T>&;
+    using ComponentsReturnType = ComponentInstances<T>&;
 
     template<typename T>
-    using ComponentsReturnType_const = const std::vector<T>&;
+    using ComponentsReturnType_const = const ComponentInstances<T>&;
 
+    ///SoA components are returned as SoARef proxies
     template<typename ...Args>
-    using EntityComponentsReturnType = std::tuple<Args&...>;
+    using EntityComponentsReturnType = std::tuple<ComponentRef<Args>...>;
 
     template<typename ...Args>
-    using EntityComponentsReturnType_const = std::tuple<const Args&...>;
+    using EntityComponentsReturnType_const = std::tuple<ComponentRef<const Args>...>;
 #endif
 
 
-    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType>
+    ///entities_capacity only caps count of entity slots, slots are allocated page by page as entities are created
+    ///(MaxEntitiesCount leaves them capped by entity index range only),
+    ///with Registry<...> as ComponentsRegistry only listed components can be used, their ids are constexpr
+    ///and their storages are members of the manager, RuntimeRegistry assigns ids and creates storages on first use
+    template<size_t entities_capacity, size_t components_capacity, typename BitsStorageType,
+             typename ComponentsRegistry = RuntimeRegistry>
     requires std::is_unsigned_v<BitsStorageType>
     class EntityManager
     {
-        template<typename T, bool ThreadSafeStorage> auto
-        StorageCaster() const
-        {
-            return static_cast<ComponentsStorage<components_capacity, BitsStorageType, T, ThreadSafeStorage>*>
-            (_componentStorages[ID::get<T>()].get());
-        }
+        static_assert(entities_capacity <= MaxEntitiesCount, "entities capacity exceeds entity index range");
+        static_assert(ComponentsRegistry::Count <= components_capacity, "registry has more components than components capacity");
+
+        template<typename, typename...>
+        friend class View;
+
+        template<typename>
+        friend class CommandBuffer;
 
         public:
-            EntityManager()
+            template<typename T, bool ThreadSafeStorage>
+            using ComponentsStorageType = ComponentsStorage<components_capacity, BitsStorageType, T, ThreadSafeStorage>;
+
+            using CommandBufferType = CommandBuffer<EntityManager>;
+
+        private:
+            using ComponentsBits = Bits<BitsStorageType, components_capacity>;
+
+            template<typename T>
+            static constexpr std::size_t ComponentId()
             {
-                _freeEntities.reserve(entities_capacity);
-                _activeEntities.reserve(entities_capacity);
+                if constexpr(ComponentsRegistry::Static)
+                {
+                    static_assert(ComponentsRegistry::template Contains<T>, "component isn't registered");
+                    return ComponentsRegistry::template IdOf<T>;
+                }
+                else
+                {
+                    return ID::get<T>();
+                }
+            }
+
+            template<typename T, bool ThreadSafeStorage> auto
+            StorageCaster() const
+            {
+                static_assert(!TagComponent<T>, "tag components have no instances, test them with HasComponents or views");
+
+                if constexpr(ComponentsRegistry::Static)
+                {
+                    static_assert(ComponentsRegistry::template ThreadSafeStorage<T> == ThreadSafeStorage,
+                                  "component is registered with the other storage kind");
+                    return const_cast<ComponentsStorageType<T, ThreadSafeStorage>*>(&std::get<ComponentId<T>()>(_registeredStorages));
+                }
+                else
+                {
+                    return static_cast<ComponentsStorageType<T, ThreadSafeStorage>*>(_componentStorages[ID::get<T>()].get());
+                }
+            }
+
+        public:
+            ///component instances are allocated from resource, it has to outlive the manager and be thread safe
+            ///if thread safe components are added concurrently (e.g. std::pmr::synchronized_pool_resource)
+            explicit EntityManager(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+                : _resource(resource), _registeredStorages(MakeRegisteredStorages(resource))
+            {
+                // registered storages took runtime ids in their constructors, registered ids replace them
+                [this]<std::size_t ...Ids>(std::index_sequence<Ids...>){
+                    ((std::get<Ids>(_registeredStorages)._componentBits.ResetAll(), std::get<Ids>(_registeredStorages)._componentBits.Set(Ids)), ...);
+                }(std::make_index_sequence<ComponentsRegistry::Count>{});
             }
 
             EntityManager(const EntityManager&) = delete;
@@ -61,15 +125,32 @@ namespace MyECS
             requires std::is_base_of_v<System<components_capacity, BitsStorageType>, DerivedSystemType>
             DerivedSystemType* CreateSystem(T<ManagedTypes...>, Args&&...);
 
+            ///InvalidEntity when all entities_capacity slots are taken (components aren't added then)
             template<bool ThreadSafeComponents, typename ...Args>
             Entity CreateEntity(Args&&... components);
 
+            ///creates count entities with Args components, generator(i) returns std::tuple<Args...> of i-th entity,
+            ///storages are grown once and locked once per batch of generated components, every system is notified once,
+            ///fewer entities are created when entities_capacity runs out
+            template<bool ThreadSafeComponents, typename ...Args, typename Generator>
+            std::vector<Entity> CreateEntities(std::size_t count, Generator&& generator);
+
             template<bool ThreadSafeComponents, typename ...Args>
             void AddComponents(Entity, Args&&... components);
 
+            ///constructs T component of the entity from args directly in the storage
+            template<bool ThreadSafeComponent, typename T, typename ...CtorArgs>
+            void EmplaceComponent(Entity, CtorArgs&&... args);
+
+            ///adds Args components to all given entities, generator(i) returns std::tuple<Args...> of entities[i]
+            template<bool ThreadSafeComponents, typename ...Args, typename Generator>
+            void AddComponentsBulk(std::span<const Entity> entities, Generator&& generator);
+
             template<typename T>
             void PreinitThreadSafeComponentStorage();
 
+            ///notifies systems about thread safe component changes made since last call, every changed entity
+            ///is evaluated once per interested system no matter how many times it was changed
             void ExecPendingUpdates();
 
             template<typename ...Args>
@@ -84,40 +165,334 @@ namespace MyECS
             template<typename ...Args>
             EntityComponentsReturnType<Args...> GetEntityComponents(Entity);
 
+            ///references of thread safe components aren't guarded, other threads may move instances as soon as storage
+            ///lock is released, so they're valid only while nobody writes the storages, readers racing with writers use
+            ///ReadComponent (in place, under the lock) or GetEntityComponentsCopy
             template<bool ThreadSafeComponents, typename ...Args>
             EntityComponentsReturnType_const<Args...> GetEntityComponents(Entity) const;
 
+            ///copies of thread safe components, each taken under its storage's lock, heavy components are deep copied
+            template<typename ...Args>
+            std::tuple<Args...> GetEntityComponentsCopy(Entity) const;
+
+            ///calls fn(const T&) with thread safe T of the entity while its storage's read lock is held, returns its result
+            template<typename T, typename Fn>
+            decltype(auto) ReadComponent(Entity, Fn&& fn) const;
+
             template<typename T>
             ComponentsReturnType<T> GetComponents();
 
+            ///dense instances aren't locked, thread safe storage mustn't be written while they're used
             template<bool ThreadSafeComponents, typename T>
             ComponentsReturnType_const<T> GetComponents() const;
 
+            ///processes all T components (non thread safe storage) in chunks of grainSize components on the thread pool,
+            ///chunks start at cache line boundaries, fn is called either as fn(Entity, T&) for every component
+            ///or as fn(std::span<const Entity>, std::span<T>) once per chunk (SoARef<T> and SoASpan<T> for SoA components),
+            ///grainSize 0 picks chunk size from components and threads count, storage mustn't be structurally modified
+            ///until it returns
+            template<typename T, typename Fn>
+            void ParallelEach(Fn&& fn, std::size_t grainSize = 0);
+
+            ///view over entities which have all Args components, iterating it yields (Entity, Args&...),
+            ///tag components filter entities without yielding anything
+            template<typename ...Args>
+            View<EntityManager, Args...> GetView();
+
+            ///opt-in table layout for entities which have all Args components: their Args instances are kept at the front
+            ///of every Args storage in the same order, so EachInGroup walks contiguous columns, rows are swapped in and out
+            ///as entities gain and lose Args, Args storages are non thread safe, false when some of Args is grouped already
+            template<typename ...Args>
+            bool CreateGroup();
+
+            ///calls fn(Entity, Args&...) (SoARef<T> for SoA components) for every entity of the group which owns Args,
+            ///Args can be a part of the group's components, components mustn't be added or removed until it returns
+            template<typename ...Args, typename Fn>
+            void EachInGroup(Fn&& fn);
+
             void RemoveEntity(Entity);
 
+            ///false for handles of removed entities even if their slot was reused
+            bool IsAlive(Entity entity) const
+            {
+                return _entitiesTable.Contains(entity);
+            }
+
+            ///alive entities packed in memory, order changes when entities are removed
+            std::span<const Entity> GetAliveEntities() const { return _aliveEntities.GetEntities(); }
+            std::size_t AliveEntitiesCount() const { return _aliveEntities.Size(); }
+
+            ///count of allocated pages of entity slots
+            std::size_t EntityPagesCount() const { return _entitiesTable.PagesCount(); }
+
+            ///applies recorded commands buffer after buffer in given order and clears the buffers,
+            ///systems are notified once per touched entity after all commands are applied
+            void Flush(std::span<CommandBufferType> commandBuffers);
+            void Flush(CommandBufferType& commandBuffer);
+
+            ///writes entity table and dense arrays of all storages to snapshot, trivially copyable components are copied
+            ///as they are, others need Serializer<T>, false (snapshot untouched) when some component has neither,
+            ///runtime ids hold only within the process, snapshots loaded by other builds need Registry
+            bool SaveSnapshot(std::vector<std::byte>& snapshot) const;
+
+            ///replaces the whole world with the snapshot (e.g. MappedSnapshot::GetData()), systems are notified about
+            ///entities which left or joined them, storages of runtime ids have to exist already,
+            ///world is left empty when snapshot turns out to be corrupted
+            bool LoadSnapshot(std::span<const std::byte> snapshot);
+
+            ///T instances get current change tick when they're added, handed out mutable by GetEntityComponents
+            ///or GetComponents, or marked with MarkChanged, instances present at the time of the call count as changed
+            template<bool ThreadSafeComponent, typename T>
+            void EnableChangeTracking();
+
+            ///for changes made through references obtained otherwise (views, groups, ParallelEach, kept references)
+            template<typename T>
+            void MarkChanged(Entity);
+
+            ///change tick stamped on changes of tracked components, starts at 1
+            ChangeTick GetChangeTick() const { return _changeTick; }
+
+            ///changes made from now on are stamped with returned tick, CollectChanges(previous tick) collects them
+            ChangeTick AdvanceChangeTick() { return ++_changeTick; }
+
+            ///(entity, component id) pairs of tracked components changed or removed after since, only blocks of
+            ///instances holding changes are scanned, removed entities show up with all their tracked components
+            ChangeSet CollectChanges(ChangeTick since) const;
+            void CollectChanges(ChangeTick since, ChangeSet& changes) const;
+
+            ///forgets removals made up to until, to be called when every consumer has collected them
+            void DiscardChanges(ChangeTick until);
+
+            ///fn(std::span<const Entity>) gets entities which T was added to, called by DispatchObservers
+            ///with batches of events recorded since the previous dispatch
+            template<typename T, typename Fn>
+            ObserverId OnAdd(Fn&& fn) { return _observers.Add(ComponentId<T>(), ComponentEvent::Add, std::forward<Fn>(fn)); }
+
+            ///entities which T was detached from or which were removed with T, instances are gone by the time
+            ///of dispatch and handles of removed entities aren't alive anymore
+            template<typename T, typename Fn>
+            ObserverId OnRemove(Fn&& fn) { return _observers.Add(ComponentId<T>(), ComponentEvent::Remove, std::forward<Fn>(fn)); }
+
+            ///entities whose T was handed out mutable by GetEntityComponents or marked with MarkChanged,
+            ///entity changed several times shows up several times
+            template<typename T, typename Fn>
+            ObserverId OnChange(Fn&& fn) { return _observers.Add(ComponentId<T>(), ComponentEvent::Change, std::forward<Fn>(fn)); }
+
+            bool RemoveObserver(ObserverId id) { return _observers.Remove(id); }
+
+            ///hands queued component events to observers, UpdateSystems calls it before systems run,
+            ///snapshot loads don't raise events and drop the queued ones
+            void DispatchObservers() { _observers.Dispatch(); }
+
+            ///singleton (resource) of type T belonging to the world rather than to any entity, replaces present one,
+            ///singletons aren't seen by systems, views or snapshots
+            template<typename T, typename ...CtorArgs>
+            T& SetSingleton(CtorArgs&&... args) { return _singletons.Emplace<T>(std::forward<CtorArgs>(args)...); }
+
+            ///T singleton has to be set
+            template<typename T>
+            T& GetSingleton() { return _singletons.Get<T>(); }
+
+            template<typename T>
+            const T& GetSingleton() const { return _singletons.Get<T>(); }
+
+            ///nullptr when T singleton isn't set
+            template<typename T>
+            T* FindSingleton() const { return _singletons.Find<T>(); }
+
+            template<typename T>
+            void RemoveSingleton() { _singletons.Erase<T>(); }
+
+            ///sorts instances of every storage by entity index, so joins of storages walk them in the same order, or with
+            ///Primary puts instances of other storages in order of Primary's instances (instances of entities without
+            ///Primary stay behind them), shrinks storages left mostly empty and makes freed entity slots reused
+            ///lowest index first, views have to be iterated anew afterwards
+            template<typename Primary = void>
+            void Compact();
+
+            ///continues Compact pass by at most budget entities, true once the pass is finished (the next call starts
+            ///a new one), changes made between steps are allowed and only make the order less sequential
+            template<typename Primary = void>
+            bool DefragmentStep(std::size_t budget);
+
+            ///runs OnUpdate of all systems, systems which don't conflict on components run in parallel
+            void UpdateSystems();
+
+            ///makes manager use given pool instead of its own one, pool has to outlive the manager
+            void UseThreadPool(ThreadPool&);
+            ThreadPool& GetThreadPool();
+
+            const Scheduler<components_capacity, BitsStorageType>& GetScheduler() const { return _scheduler; }
+
+#ifdef MYECS_INSTRUMENTATION
+            ///entity table and storages memory, latency histograms of core operations since last ResetStats
+            WorldStats GetStats() const;
+            void ResetStats();
+
+            ///records frames and systems' OnUpdate of UpdateSystems while recording
+            TraceRecorder& GetTraceRecorder() { return _trace; }
+#endif
+
+            std::pmr::memory_resource* GetMemoryResource() const { return _resource; }
+
         private:
+            ///InvalidEntity when there's no free slot
+            Entity AllocateEntity();
+
+            ///frees entity slot, next allocation of the slot gets handle of the next generation
+            void ReleaseEntity(Entity);
+
+            ///adds components without notifying systems
+            template<bool ThreadSafeComponents, typename ...Args>
+            void AttachComponents(Entity, Args&&... components);
+
+            template<bool ThreadSafeComponents, typename ...Args, typename Generator>
+            void AttachComponentsBulk(std::span<const Entity>, Generator&& generator);
+
             template<bool ThreadSafeComponent, typename T>
             std::size_t AddComponent(Entity, T&& component);
 
+            ///overwrites present T component of the entity, systems aren't notified as components don't change
+            template<bool ThreadSafeComponent, typename T>
+            void AssignComponent(Entity, T&& component);
+
+            template<bool ThreadSafeComponent, typename T>
+            ComponentsStorageType<T, ThreadSafeComponent>* AssureStorage();
+
+            ///notifies systems interested in changed components, thread safe changes are deferred to ExecPendingUpdates
+            template<bool Deferred>
+            void NotifyEntityUpdate(Entity, const ComponentsBits& changedComponents);
+
+            void RecordPendingUpdates(std::span<const Entity>, const ComponentsBits& changedComponents);
+
             template<typename T>
             void DetachComponent(Entity);
 
+            template<typename T>
+            void DeleteComponentInstance(Entity);
+
+            ///deletes instances of all given components of the entity
+            void DeleteComponentInstances(Entity, const ComponentsBits& components);
+
             template<typename ...Args>
             std::vector<Entity> GetEntitiesWithComponents();
 
+            template<typename ...Args>
+            static constexpr ComponentsBits MakeComponentsMask();
+
+            static auto MakeRegisteredStorages(std::pmr::memory_resource* resource)
+            {
+                return [resource]<std::size_t ...Ids>(std::index_sequence<Ids...>){
+                    return typename ComponentsRegistry::template Storages<ComponentsStorageType>{((void)Ids, resource)...};
+                }(std::make_index_sequence<ComponentsRegistry::Count>{});
+            }
+
+            ///ids of components which have storage
+            ComponentsBits StoredComponents() const;
+
+            BaseComponentsStorage<components_capacity, BitsStorageType>* GetStorage(std::size_t componentId) const;
+
+            ///removes all entities and components without notifying systems
+            void ClearWorld();
+
+            ///brings managed entities of every system in line with current world
+            void SyncSystemsWithWorld();
+
+            ///calls fn(system) once for every system which manages any of given components
+            template<typename Fn>
+            void ForEachInterestedSystem(const ComponentsBits& components, Fn&& fn);
+
+            ///moves instances of the entity into the groups whose components it has got
+            void JoinGroups(Entity);
+
+            ///moves instances of the entity out of the groups which own any of leaving components,
+            ///called before the instances are deleted, so swap-and-pop of storages doesn't reach into groups
+            void LeaveGroups(Entity, const ComponentsBits& leaving);
+
+            ///puts all alive entities into groups anew after storages were replaced
+            void RebuildGroups();
+
         private:
-            std::array<Bits<BitsStorageType, components_capacity>, entities_capacity> _entitiesComponentsSlots;
-            Bits<BitsStorageType, entities_capacity> _entitiesStates;
-            std::unordered_map<Entity, Entity> _activeEntities;
+            ///handles and components masks of entities
+            EntityTable<ComponentsBits> _entitiesTable;
+            ///dense list of alive entities (swap-and-pop on removal), its size is also the next never used slot
+            SparseSet<> _aliveEntities;
+            ///bumped whenever tag component is added to or removed from any entity, views with tags compare it,
+            ///atomic as thread safe additions bump it concurrently
+            std::atomic<std::size_t> _tagsVersion{0};
             std::vector<Entity> _freeEntities;
 
+            std::pmr::memory_resource* _resource;
+            ChangeTick _changeTick{1};
             std::array<std::unique_ptr<BaseComponentsStorage<components_capacity, BitsStorageType>>, components_capacity> _componentStorages;
             std::size_t _componentsCount{0};
             Bits<BitsStorageType, components_capacity> _activeComponentsMask;
+            ///storages of registered components, ids are indices in the tuple
+            typename ComponentsRegistry::template Storages<ComponentsStorageType> _registeredStorages;
 
-            std::deque<std::packaged_task<void()>> _pendingUpdates;
+            ///deferred notifications of thread safe component changes, one record per entity,
+            ///_pendingEntities maps entity to its record, records are swapped with _executedUpdates
+            ///on ExecPendingUpdates and only cleared, so steady state doesn't allocate
+            struct PendingUpdate
+            {
+                Entity entity;
+                ComponentsBits changedComponents;
+            };
+
+            SparseSet<> _pendingEntities;
+            std::vector<PendingUpdate> _pendingUpdates;
+            std::vector<PendingUpdate> _executedUpdates;
+            std::mutex _pendingUpdatesMutex;
             std::vector<std::unique_ptr<System<components_capacity, BitsStorageType>>> _systems;
 
+            ///indices of systems managing given component, systems without components are interested in every entity
+            std::array<std::vector<std::size_t>, components_capacity> _componentsSystems;
+            std::vector<std::size_t> _unfilteredSystems;
+            ///last notification in which system was visited, keeps systems from being notified twice
+            std::vector<uint32_t> _systemsStamps;
+            uint32_t _currentStamp{0};
+            ///notifications in progress, more than one when system's action changed components
+            uint32_t _notificationsDepth{0};
+
+            ///progress of Compact pass, order holds entities in which instances of current storage are being arranged
+            struct DefragmentState
+            {
+                bool running{false};
+                bool ordered{false};
+                std::size_t component{0};
+                std::size_t cursor{0};
+                std::size_t position{0};
+                std::vector<Entity> order;
+            };
+
+            DefragmentState _defragment;
+
+            ///group of components whose instances of the first size entities are at the same dense indices
+            struct Group
+            {
+                ComponentsBits components;
+                std::size_t size{0};
+                ///swaps instances of the entity with the ones at position in every storage of the group
+                void(*place)(EntityManager&, Entity, std::size_t position);
+                ///dense index of the entity in the first storage of the group, the same in all of them for its members
+                std::size_t(*indexOf)(const EntityManager&, Entity);
+            };
+
+            std::vector<Group> _groups;
+
+            Singletons _singletons;
+            Observers _observers{components_capacity};
+
+            Scheduler<components_capacity, BitsStorageType> _scheduler;
+            bool _schedulerOutdated{false};
+            std::unique_ptr<ThreadPool> _ownThreadPool;
+            ThreadPool* _threadPool{nullptr};
+
+#ifdef MYECS_INSTRUMENTATION
+            std::array<LatencyHistogram, static_cast<std::size_t>(Operation::Count)> _latencies;
+            TraceRecorder _trace;
+#endif
+
     };
 }
 
@@ -0,0 +1,73 @@
+#ifndef MYECS_ENTITYTABLE_H
+#define MYECS_ENTITYTABLE_H
+
+#include <Inc/Entity.h>
+#include <array>
+#include <bit>
+#include <memory>
+#include <vector>
+
+namespace MyECS
+{
+    ///paged table of entity slots, slot keeps handle of the entity occupying it and its components,
+    ///page is allocated when its first slot is acquired and freed when its last slot is released
+    ///(the last freed page is kept for reuse so entities created and removed at page boundary don't reallocate it)
+    template<typename Components, std::size_t page_size = 4096> requires (std::has_single_bit(page_size))
+    class EntityTable
+    {
+        public:
+            ///false for handles of entities which don't occupy their slot anymore
+            bool Contains(Entity) const;
+
+            ///makes entity occupy its slot, components of the slot are cleared
+            void Acquire(Entity);
+
+            ///frees slot of the entity, entity has to be contained
+            void Release(Entity);
+
+            ///frees all slots and pages
+            void Clear() { _pages.clear(); _pagesCount = 0; }
+
+            ///components of the entity, entity has to be contained
+            Components& GetComponents(Entity entity) { return Slot(entity, &Page::components); }
+            const Components& GetComponents(Entity entity) const { return Slot(entity, &Page::components); }
+
+            ///components of the entity or nullptr when entity doesn't occupy its slot
+            const Components* FindComponents(Entity entity) const { return Contains(entity) ? &GetComponents(entity) : nullptr; }
+
+            std::size_t PagesCount() const { return _pagesCount; }
+            static constexpr std::size_t PageSize() { return page_size; }
+
+            ///bytes of allocated pages (spare one included) and of the pages index
+            std::size_t MemoryUsage() const
+            {
+                return (_pagesCount + (_sparePage ? 1 : 0)) * sizeof(Page) + _pages.capacity() * sizeof(std::unique_ptr<Page>);
+            }
+
+        private:
+            static constexpr std::size_t _pageShift = std::bit_width(page_size) - 1;
+            static constexpr std::size_t _pageMask = page_size - 1;
+
+            struct Page
+            {
+                std::array<Entity, page_size> handles;
+                std::array<Components, page_size> components;
+                std::size_t occupied{0};
+            };
+
+            template<typename T>
+            T& Slot(Entity entity, std::array<T, page_size> Page::* column) const
+            {
+                const Entity index = GetEntityIndex(entity);
+                return ((*_pages[index >> _pageShift]).*column)[index & _pageMask];
+            }
+
+            std::vector<std::unique_ptr<Page>> _pages;
+            std::unique_ptr<Page> _sparePage;
+            std::size_t _pagesCount{0};
+    };
+}
+
+#include "Impl/EntityTable_impl.tpp"
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef MYECS_INSTRUMENTATION_H
+#define MYECS_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+///EntityManager, storages and scheduler are instrumented only when MYECS_INSTRUMENTATION is defined
+///(cmake -DMYECS_INSTRUMENTATION=ON), otherwise none of the hooks, members or GetStats() exist
+
+namespace MyECS
+{
+    enum class Operation : uint8_t
+    {
+        CreateEntity,
+        AddComponents,
+        DetachComponents,
+        RemoveEntity,
+        ///systems notified about changed entity (per entity, pending updates and flushes included)
+        NotifySystems,
+        Count
+    };
+
+    const char* OperationName(Operation);
+
+    ///lock-free latency histogram, bucket i counts samples shorter than 2^i ns (and at least 2^(i-1) ns)
+    class LatencyHistogram
+    {
+        public:
+            static constexpr std::size_t BucketsCount{40};
+
+            struct Snapshot
+            {
+                uint64_t count{0};
+                uint64_t totalNs{0};
+                uint64_t maxNs{0};
+                std::array<uint64_t, BucketsCount> buckets{};
+
+                std::chrono::nanoseconds Mean() const { return std::chrono::nanoseconds{count ? totalNs / count : 0}; }
+
+                ///upper bound of the bucket holding given quantile (0..1)
+                std::chrono::nanoseconds Percentile(double quantile) const;
+            };
+
+            void Record(std::chrono::nanoseconds);
+            Snapshot Read() const;
+            void Reset();
+
+        private:
+            std::array<std::atomic<uint64_t>, BucketsCount> _buckets{};
+            std::atomic<uint64_t> _count{0};
+            std::atomic<uint64_t> _totalNs{0};
+            std::atomic<uint64_t> _maxNs{0};
+    };
+
+    ///records duration of the scope to histogram
+    class ScopedLatency
+    {
+        public:
+            explicit ScopedLatency(LatencyHistogram& histogram)
+                : _histogram(histogram), _start(std::chrono::steady_clock::now()) {}
+
+            ~ScopedLatency() { _histogram.Record(std::chrono::steady_clock::now() - _start); }
+
+            ScopedLatency(const ScopedLatency&) = delete;
+            ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+        private:
+            LatencyHistogram& _histogram;
+            std::chrono::steady_clock::time_point _start;
+    };
+
+    struct StorageStats
+    {
+        std::size_t componentId;
+        std::size_t componentSize;
+        bool threadSafe;
+        std::size_t size;
+        std::size_t capacity;
+        ///bytes allocated for instances, sparse set (pages and dense entities) and change ticks
+        std::size_t instancesBytes;
+        std::size_t sparseSetBytes;
+        std::size_t changeTrackingBytes;
+        ///locks of thread safe storage which had to wait for another thread
+        uint64_t contendedLocks;
+
+        std::size_t AllocatedBytes() const { return instancesBytes + sparseSetBytes + changeTrackingBytes; }
+
+        ///part of allocated dense capacity not holding instances
+        double Fragmentation() const { return capacity ? 1.0 - static_cast<double>(size) / static_cast<double>(capacity) : 0.0; }
+    };
+
+    struct WorldStats
+    {
+        std::size_t aliveEntities;
+        std::size_t freeEntities;
+        std::size_t entityPages;
+        std::size_t entityTableBytes;
+        ///part of slots of allocated entity pages which aren't occupied
+        double entityTableFragmentation;
+        std::size_t systemsCount;
+
+        std::array<LatencyHistogram::Snapshot, static_cast<std::size_t>(Operation::Count)> operations;
+        std::vector<StorageStats> storages;
+
+        const LatencyHistogram::Snapshot& Get(Operation operation) const { return operations[static_cast<std::size_t>(operation)]; }
+    };
+
+    ///collects complete events of frames and writes them in Chrome trace event format
+    ///(loadable in chrome://tracing and ui.perfetto.dev), events are recorded only between Start and Stop
+    class TraceRecorder
+    {
+        public:
+            void Start();
+            void Stop() { _recording.store(false, std::memory_order_relaxed); }
+            bool IsRecording() const { return _recording.load(std::memory_order_relaxed); }
+
+            ///category has to outlive the recorder (string literal)
+            void Record(std::string_view name, const char* category,
+                        std::chrono::steady_clock::time_point start, std::chrono::nanoseconds duration);
+
+            std::size_t EventsCount() const;
+            void Clear();
+
+            std::string ToChromeTraceJson() const;
+            bool WriteChromeTrace(const char* path) const;
+
+        private:
+            struct Event
+            {
+                std::string name;
+                const char* category;
+                std::chrono::nanoseconds start;
+                std::chrono::nanoseconds duration;
+                uint32_t threadId;
+            };
+
+            uint32_t ThreadIdOf(std::thread::id);
+
+            std::atomic<bool> _recording{false};
+            std::chrono::steady_clock::time_point _origin;
+
+            mutable std::mutex _mutex;
+            std::vector<Event> _events;
+            std::vector<std::thread::id> _threads;
+    };
+}
+
+#endif
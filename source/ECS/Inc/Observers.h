@@ -0,0 +1,103 @@
+#ifndef MYECS_OBSERVERS_H
+#define MYECS_OBSERVERS_H
+
+#include <Inc/Entity.h>
+#include <array>
+#include <cinttypes>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace MyECS
+{
+    enum class ComponentEvent : uint8_t
+    {
+        Add,
+        Remove,
+        Change,
+        Count
+    };
+
+    using ObserverId = uint64_t;
+
+    ///observers of component events, events of observed (component, event) pairs are queued as they happen
+    ///and handed to observers by Dispatch, every observer gets all entities of its (component, event) pair
+    ///queued since the last dispatch in one batch (span of entities, in order they happened), events of
+    ///components nobody observes cost one check, observers mustn't be added or removed while events are
+    ///recorded or dispatched
+    class Observers
+    {
+        public:
+            using Callback = std::function<void(std::span<const Entity>)>;
+
+            explicit Observers(std::size_t componentsCapacity);
+
+            ObserverId Add(std::size_t componentId, ComponentEvent, Callback);
+
+            ///false when observer doesn't exist
+            bool Remove(ObserverId);
+
+            bool Observes(std::size_t componentId, ComponentEvent event) const
+            {
+                return _observed[componentId] & (1u << static_cast<uint8_t>(event));
+            }
+
+            bool ObservesAny(ComponentEvent event) const { return _observersCount[static_cast<std::size_t>(event)] != 0; }
+
+            ///queues event if it's observed, thread safe
+            void Record(std::size_t componentId, ComponentEvent event, Entity entity)
+            {
+                if(Observes(componentId, event))
+                    Append(componentId, event, std::span<const Entity>{&entity, 1});
+            }
+
+            void Record(std::size_t componentId, ComponentEvent event, std::span<const Entity> entities)
+            {
+                if(Observes(componentId, event) && !entities.empty())
+                    Append(componentId, event, entities);
+            }
+
+            ///calls observers with events queued since last dispatch, events recorded by observers
+            ///are dispatched by the next call
+            void Dispatch();
+
+            ///drops queued events
+            void Clear();
+
+        private:
+            struct Observer
+            {
+                ObserverId id;
+                ComponentEvent event;
+                Callback callback;
+            };
+
+            ///entities of events of one component, list per event
+            struct Queue
+            {
+                std::array<std::vector<Entity>, static_cast<std::size_t>(ComponentEvent::Count)> entities;
+                bool queued{false};
+
+                void Clear();
+            };
+
+            void Append(std::size_t componentId, ComponentEvent, std::span<const Entity>);
+
+            std::vector<std::vector<Observer>> _observers;
+            ///bit per observed event of every component
+            std::vector<uint8_t> _observed;
+            std::array<std::size_t, static_cast<std::size_t>(ComponentEvent::Count)> _observersCount{};
+            ObserverId _nextId{0};
+
+            ///queues are swapped on dispatch and only cleared, so steady state doesn't allocate
+            std::vector<Queue> _pending;
+            std::vector<Queue> _dispatching;
+            std::vector<std::size_t> _pendingComponents;
+            std::vector<std::size_t> _dispatchingComponents;
+            std::mutex _mutex;
+    };
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef MYECS_REGISTRY_H
+#define MYECS_REGISTRY_H
+
+#include <cinttypes>
+#include <array>
+#include <tuple>
+#include <type_traits>
+
+namespace MyECS
+{
+    ///marks registered component which is kept in thread safe storage, Registry<Position, ThreadSafe<Health>>
+    template<typename T>
+    struct ThreadSafe {};
+
+    template<typename T>
+    struct RegistryEntry
+    {
+        using Type = T;
+        static constexpr bool ThreadSafeStorage = false;
+    };
+
+    template<typename T>
+    struct RegistryEntry<ThreadSafe<T>>
+    {
+        using Type = T;
+        static constexpr bool ThreadSafeStorage = true;
+    };
+
+    ///closed list of components known at compile time, id of component is its position in the list,
+    ///so ids are constexpr and the same in every build, storages of all components are created up front
+    template<typename ...Entries>
+    struct Registry
+    {
+        static constexpr bool Static = true;
+        static constexpr std::size_t Count = sizeof...(Entries);
+
+        template<typename T>
+        static constexpr bool Contains = (std::is_same_v<T, typename RegistryEntry<Entries>::Type> || ...);
+
+        template<typename T>
+        static constexpr std::size_t IdOf = []{
+            constexpr std::array<bool, Count> matches{std::is_same_v<T, typename RegistryEntry<Entries>::Type>...};
+
+            std::size_t id{0};
+            while(id < Count && !matches[id])
+                ++id;
+
+            return id;
+        }();
+
+        template<typename T>
+        static constexpr bool ThreadSafeStorage = ((std::is_same_v<T, typename RegistryEntry<Entries>::Type>
+                                                   && RegistryEntry<Entries>::ThreadSafeStorage) || ...);
+
+        template<std::size_t Id>
+        using TypeAt = typename RegistryEntry<std::tuple_element_t<Id, std::tuple<Entries...>>>::Type;
+
+        template<template<typename, bool> class Storage>
+        using Storages = std::tuple<Storage<typename RegistryEntry<Entries>::Type, RegistryEntry<Entries>::ThreadSafeStorage>...>;
+
+        private:
+            template<typename T>
+            static constexpr std::size_t _occurrences = (std::size_t{std::is_same_v<T, typename RegistryEntry<Entries>::Type>} + ... + 0);
+
+            static_assert(((_occurrences<typename RegistryEntry<Entries>::Type> == 1) && ...), "component registered more than once");
+    };
+
+    ///default, components get ids from ID::get on first use and storages are created on demand
+    struct RuntimeRegistry
+    {
+        static constexpr bool Static = false;
+        static constexpr std::size_t Count = 0;
+
+        template<template<typename, bool> class Storage>
+        using Storages = std::tuple<>;
+    };
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef MYECS_SCHEDULER_H
+#define MYECS_SCHEDULER_H
+
+#include <Inc/System.h>
+#include <Inc/ThreadPool.h>
+#include <chrono>
+#ifdef MYECS_INSTRUMENTATION
+#include <Inc/Instrumentation.h>
+#include <typeinfo>
+#endif
+
+namespace MyECS
+{
+    ///runs systems' OnUpdate once per frame, system depends on every earlier registered system it conflicts with
+    ///(one writes component which the other reads or writes), systems without dependencies between them run in parallel
+    template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
+    class Scheduler
+    {
+        using SystemType = System<components_capacity, BitsStorageType>;
+
+        public:
+            struct SystemTiming
+            {
+                const SystemType* system;
+                std::chrono::nanoseconds duration;
+                ///end of the longest dependency chain finishing with this system
+                std::chrono::nanoseconds pathDuration;
+            };
+
+            void Build(const std::vector<std::unique_ptr<SystemType>>& systems);
+#ifdef MYECS_INSTRUMENTATION
+            ///systems' OnUpdate is recorded to trace while it's recording
+            void Run(ThreadPool&, TraceRecorder* trace = nullptr);
+#else
+            void Run(ThreadPool&);
+#endif
+
+            const std::vector<SystemTiming>& GetTimings() const { return _timings; }
+
+            ///systems (indices in registration order) forming the longest dependency chain of the last frame
+            const std::vector<std::size_t>& GetCriticalPath() const { return _criticalPath; }
+            std::chrono::nanoseconds GetCriticalPathDuration() const;
+
+            const std::vector<std::size_t>& GetDependencies(std::size_t system) const { return _nodes[system].dependencies; }
+
+        private:
+            struct Node
+            {
+                SystemType* system;
+                std::vector<std::size_t> dependencies;
+                std::vector<std::size_t> dependents;
+            };
+
+            static bool Conflict(const SystemType&, const SystemType&);
+
+            void RunNode(ThreadPool&, std::size_t node);
+            void ComputeCriticalPath();
+
+            std::vector<Node> _nodes;
+            std::unique_ptr<std::atomic<std::size_t>[]> _remainingDependencies;
+            std::atomic<std::size_t> _remainingNodes{0};
+
+            std::vector<SystemTiming> _timings;
+            std::vector<std::size_t> _criticalPath;
+
+#ifdef MYECS_INSTRUMENTATION
+            TraceRecorder* _trace{nullptr};
+#endif
+    };
+}
+
+#include "Impl/Scheduler_impl.tpp"
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef MYECS_SINGLETONS_H
+#define MYECS_SINGLETONS_H
+
+#include <Inc/TypeIdGenerator.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace MyECS
+{
+    ///at most one instance of every type, kept apart from entities (world configuration, input state, ...),
+    ///instances are found by index of their type, so access doesn't hash or go through entity lookups
+    class Singletons
+    {
+        public:
+            ///constructs T from args, replaces present instance
+            template<typename T, typename ...CtorArgs>
+            T& Emplace(CtorArgs&&... args)
+            {
+                const auto id = SingletonID::get<T>();
+                if(id >= _instances.size())
+                    _instances.resize(id + 1);
+
+                auto instance = std::make_unique<T>(std::forward<CtorArgs>(args)...);
+                T& reference = *instance;
+                _instances[id] = Instance{instance.release(), Deleter{[](void* object){ delete static_cast<T*>(object); }}};
+
+                return reference;
+            }
+
+            ///T has to be present
+            template<typename T>
+            T& Get() { return *static_cast<T*>(_instances[SingletonID::get<T>()].get()); }
+
+            template<typename T>
+            const T& Get() const { return *static_cast<const T*>(_instances[SingletonID::get<T>()].get()); }
+
+            ///nullptr when T isn't present
+            template<typename T>
+            T* Find() const
+            {
+                const auto id = SingletonID::get<T>();
+                return id < _instances.size() ? static_cast<T*>(_instances[id].get()) : nullptr;
+            }
+
+            template<typename T>
+            bool Contains() const { return Find<T>() != nullptr; }
+
+            template<typename T>
+            void Erase()
+            {
+                const auto id = SingletonID::get<T>();
+                if(id < _instances.size())
+                    _instances[id].reset();
+            }
+
+            void Clear() { _instances.clear(); }
+
+        private:
+            struct Deleter
+            {
+                void(*destroy)(void*){nullptr};
+
+                void operator()(void* object) const { destroy(object); }
+            };
+
+            using Instance = std::unique_ptr<void, Deleter>;
+
+            std::vector<Instance> _instances;
+    };
+}
+
+#endif
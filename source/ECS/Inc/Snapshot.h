@@ -0,0 +1,259 @@
+#ifndef MYECS_SNAPSHOT_H
+#define MYECS_SNAPSHOT_H
+
+#include <Inc/Entity.h>
+#include <Inc/SparseSet.h>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstring>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace MyECS
+{
+    ///appends raw bytes to a snapshot buffer
+    class SnapshotWriter
+    {
+        public:
+            explicit SnapshotWriter(std::vector<std::byte>& buffer) : _buffer(buffer) {}
+
+            void Write(const void* data, std::size_t size);
+
+            template<typename T> requires std::is_trivially_copyable_v<T>
+            void Write(const T& value) { Write(&value, sizeof(T)); }
+
+            ///overwrites already written bytes, used to fill in sizes known only after the data is written
+            void Patch(std::size_t offset, const void* data, std::size_t size);
+
+            std::size_t Offset() const { return _buffer.size(); }
+
+        private:
+            std::vector<std::byte>& _buffer;
+    };
+
+    ///reads raw bytes of a snapshot, reading past the end fails and leaves reader failed
+    class SnapshotReader
+    {
+        public:
+            explicit SnapshotReader(std::span<const std::byte> data) : _data(data) {}
+
+            bool Read(void* data, std::size_t size);
+            bool Skip(std::size_t size);
+
+            template<typename T> requires std::is_trivially_copyable_v<T>
+            T Read()
+            {
+                T value{};
+                Read(&value, sizeof(T));
+                return value;
+            }
+
+            ///next size bytes without copying them, empty span if there's less of them
+            std::span<const std::byte> View(std::size_t size);
+
+            std::size_t Remaining() const { return _data.size() - _offset; }
+            bool Failed() const { return _failed; }
+
+        private:
+            std::span<const std::byte> _data;
+            std::size_t _offset{0};
+            bool _failed{false};
+    };
+
+    ///specialize for components which aren't trivially copyable:
+    ///static void Save(SnapshotWriter&, const T&) and static T Load(SnapshotReader&)
+    template<typename T>
+    struct Serializer {};
+
+    template<typename CharT, typename Traits, typename Allocator>
+    struct Serializer<std::basic_string<CharT, Traits, Allocator>>
+    {
+        using String = std::basic_string<CharT, Traits, Allocator>;
+
+        static void Save(SnapshotWriter& writer, const String& string)
+        {
+            writer.Write(static_cast<uint64_t>(string.size()));
+            writer.Write(string.data(), string.size() * sizeof(CharT));
+        }
+
+        static String Load(SnapshotReader& reader)
+        {
+            const auto size = reader.Read<uint64_t>();
+            if(size > reader.Remaining() / sizeof(CharT))
+            {
+                reader.Skip(reader.Remaining() + 1);
+                return {};
+            }
+
+            String string(size, CharT{});
+            reader.Read(string.data(), size * sizeof(CharT));
+            return string;
+        }
+    };
+
+    ///trivially copyable components are written as they are, others need Serializer<T>
+    template<typename T>
+    concept SnapshotComponent = std::is_trivially_copyable_v<T> || requires(SnapshotWriter& writer, SnapshotReader& reader, const T& component) {
+        Serializer<T>::Save(writer, component);
+        { Serializer<T>::Load(reader) } -> std::convertible_to<T>;
+    };
+
+    ///layout: SnapshotHeader, alive entities handles, their components masks, free entities handles,
+    ///then storagesCount times SnapshotStorageHeader followed by entities of storage and payload of its instances
+    struct SnapshotHeader
+    {
+        static constexpr uint32_t Magic = 0x5343454D;
+        static constexpr uint32_t CurrentVersion = 1;
+
+        uint32_t magic{Magic};
+        uint32_t version{CurrentVersion};
+        uint32_t componentsBitsSize;
+        uint32_t storagesCount;
+        uint64_t aliveCount;
+        uint64_t freeCount;
+    };
+
+    struct SnapshotStorageHeader
+    {
+        uint32_t componentId;
+        uint32_t componentSize;
+        uint64_t count;
+        uint64_t payloadSize;
+    };
+
+    ///snapshot file mapped read only (read into memory where mmap isn't available),
+    ///restoring from it copies dense blocks straight from the mapped pages
+    class MappedSnapshot
+    {
+        public:
+            explicit MappedSnapshot(const char* path);
+            ~MappedSnapshot();
+
+            MappedSnapshot(const MappedSnapshot&) = delete;
+            MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+            bool IsOpen() const { return _data != nullptr; }
+            std::span<const std::byte> GetData() const { return {_data, _size}; }
+
+        private:
+            const std::byte* _data{nullptr};
+            std::size_t _size{0};
+            std::vector<std::byte> _fallback;
+    };
+
+    bool WriteSnapshotFile(const char* path, std::span<const std::byte> snapshot);
+
+    namespace Detail
+    {
+        ///writes storage record, false if T can't be written, instances are written as array of T whatever
+        ///the layout of the storage is, so snapshots stay valid when component switches between AoS and SoA
+        template<typename T, typename Instances>
+        bool SaveStorage(SnapshotWriter& writer, uint32_t componentId, const SparseSet<>& entities, const Instances& instances)
+        {
+            if constexpr(!SnapshotComponent<T>)
+            {
+                return false;
+            }
+            else
+            {
+                const auto headerOffset = writer.Offset();
+                SnapshotStorageHeader header{componentId, sizeof(T), instances.size(), 0};
+                writer.Write(header);
+                writer.Write(entities.GetEntities().data(), entities.Size() * sizeof(Entity));
+
+                const auto payloadOffset = writer.Offset();
+                if constexpr(std::is_trivially_copyable_v<T> && std::ranges::contiguous_range<Instances>)
+                {
+                    writer.Write(instances.data(), instances.size() * sizeof(T));
+                }
+                else if constexpr(std::is_trivially_copyable_v<T>)
+                {
+                    for(std::size_t i{0}; i<instances.size(); ++i)
+                        writer.Write(static_cast<T>(instances[i]));
+                }
+                else
+                {
+                    for(std::size_t i{0}; i<instances.size(); ++i)
+                        Serializer<T>::Save(writer, instances[i]);
+                }
+
+                header.payloadSize = writer.Offset() - payloadOffset;
+                writer.Patch(headerOffset, &header, sizeof(header));
+
+                return true;
+            }
+        }
+
+        ///replaces entities and instances with the ones of the record, reader stands after record header
+        template<typename T, typename Instances>
+        bool LoadStorage(SnapshotReader& reader, const SnapshotStorageHeader& header, SparseSet<>& entities, Instances& instances)
+        {
+            entities.Clear();
+            instances.clear();
+
+            if constexpr(!SnapshotComponent<T>)
+            {
+                return false;
+            }
+            else
+            {
+                if(header.componentSize != sizeof(T) || header.count > reader.Remaining() / sizeof(Entity))
+                    return false;
+
+                if(std::is_trivially_copyable_v<T> && header.payloadSize != header.count * sizeof(T))
+                    return false;
+
+                const auto entitiesBlock = reader.View(header.count * sizeof(Entity));
+                SnapshotReader payload{reader.View(header.payloadSize)};
+                if(reader.Failed())
+                    return false;
+
+                entities.Reserve(header.count);
+                for(std::size_t i{0}; i<header.count; ++i)
+                {
+                    Entity entity;
+                    std::memcpy(&entity, entitiesBlock.data() + i * sizeof(Entity), sizeof(Entity));
+                    entities.Insert(entity);
+                }
+
+                instances.reserve(header.count);
+                if constexpr(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> && std::ranges::contiguous_range<Instances>)
+                {
+                    instances.resize(header.count);
+                    payload.Read(instances.data(), header.count * sizeof(T));
+                }
+                else if constexpr(std::is_trivially_copyable_v<T>)
+                {
+                    for(std::size_t i{0}; i<header.count; ++i)
+                    {
+                        std::array<std::byte, sizeof(T)> bytes;
+                        payload.Read(bytes.data(), sizeof(T));
+                        instances.push_back(std::bit_cast<T>(bytes));
+                    }
+                }
+                else
+                {
+                    for(std::size_t i{0}; i<header.count && !payload.Failed(); ++i)
+                        instances.emplace_back(Serializer<T>::Load(payload));
+                }
+
+                // serializer has to consume exactly what it wrote
+                if(payload.Failed() || payload.Remaining() != 0)
+                {
+                    entities.Clear();
+                    instances.clear();
+                    return false;
+                }
+
+                return true;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef MYECS_SOA_H
+#define MYECS_SOA_H
+
+#include <algorithm>
+#include <cstring>
+#include <memory_resource>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace MyECS
+{
+    ///specialize for component which should be stored as structure of arrays, Members lists all its data members,
+    ///template<> struct MyECS::SoAFields<Particle> { static constexpr auto Members = std::make_tuple(&Particle::x, &Particle::y); };
+    ///members have to be trivially copyable, every member is kept in its own cache line aligned array
+    template<typename T>
+    struct SoAFields;
+
+    template<typename T>
+    concept SoAComponent = requires { SoAFields<std::remove_const_t<T>>::Members; };
+
+    namespace Detail
+    {
+        template<typename Member>
+        struct MemberField;
+
+        template<typename Class, typename Field>
+        struct MemberField<Field Class::*>
+        {
+            using Type = Field;
+        };
+
+        template<typename T>
+        using SoAMembers = std::remove_const_t<decltype(SoAFields<std::remove_const_t<T>>::Members)>;
+
+        template<typename T>
+        inline constexpr std::size_t SoAFieldsCount = std::tuple_size_v<SoAMembers<T>>;
+
+        ///type of I-th member, const for const T
+        template<typename T, std::size_t I>
+        using SoAField = std::conditional_t<std::is_const_v<T>,
+                                            const typename MemberField<std::tuple_element_t<I, SoAMembers<T>>>::Type,
+                                            typename MemberField<std::tuple_element_t<I, SoAMembers<T>>>::Type>;
+
+        template<typename T, auto Member>
+        constexpr std::size_t SoAFieldIndex()
+        {
+            constexpr auto& members = SoAFields<std::remove_const_t<T>>::Members;
+
+            std::size_t index{SoAFieldsCount<T>};
+            [&]<std::size_t ...I>(std::index_sequence<I...>){
+                ([&]{
+                    if constexpr(std::is_same_v<std::remove_cvref_t<decltype(std::get<I>(members))>, decltype(Member)>)
+                        if(index == SoAFieldsCount<T> && std::get<I>(members) == Member)
+                            index = I;
+                }(), ...);
+            }(std::make_index_sequence<SoAFieldsCount<T>>{});
+
+            return index;
+        }
+
+        template<typename T, typename = std::make_index_sequence<SoAFieldsCount<T>>>
+        struct SoAPointers;
+
+        template<typename T, std::size_t ...I>
+        struct SoAPointers<T, std::index_sequence<I...>>
+        {
+            using Type = std::tuple<SoAField<T, I>*...>;
+        };
+    }
+
+    ///reference to component kept in SoAVector, reads gather and writes scatter its members,
+    ///assigning one reference to another copies the component like std::vector<bool>::reference does,
+    ///SoARef<const T> for read only access
+    template<typename T> requires SoAComponent<T>
+    class SoARef
+    {
+        using Value = std::remove_const_t<T>;
+        using Pointers = typename Detail::SoAPointers<T>::Type;
+
+        public:
+            explicit SoARef(Pointers fields) : _fields(fields) {}
+            SoARef(const SoARef&) = default;
+
+            ///member of the component, ref.Get<&Particle::x>()
+            template<auto Member>
+            auto& Get() const
+            {
+                static_assert(Detail::SoAFieldIndex<T, Member>() < Detail::SoAFieldsCount<T>, "member isn't listed in SoAFields");
+                return *std::get<Detail::SoAFieldIndex<T, Member>()>(_fields);
+            }
+
+            operator Value() const;
+            operator SoARef<const Value>() const { return SoARef<const Value>{_fields}; }
+
+            const SoARef& operator=(const Value& value) const requires (!std::is_const_v<T>);
+            const SoARef& operator=(const SoARef& other) const requires (!std::is_const_v<T>)
+            {
+                return *this = static_cast<Value>(other);
+            }
+
+        private:
+            Pointers _fields;
+    };
+
+    ///count consecutive components of SoAVector, every member as a contiguous span
+    template<typename T> requires SoAComponent<T>
+    class SoASpan
+    {
+        using Pointers = typename Detail::SoAPointers<T>::Type;
+
+        public:
+            SoASpan(Pointers fields, std::size_t size) : _fields(fields), _size(size) {}
+
+            template<auto Member>
+            auto Field() const
+            {
+                constexpr auto index = Detail::SoAFieldIndex<T, Member>();
+                static_assert(index < Detail::SoAFieldsCount<T>, "member isn't listed in SoAFields");
+                return std::span<Detail::SoAField<T, index>>{std::get<index>(_fields), _size};
+            }
+
+            SoARef<T> operator[](std::size_t index) const;
+
+            std::size_t size() const { return _size; }
+            bool empty() const { return _size == 0; }
+
+        private:
+            Pointers _fields;
+            std::size_t _size;
+    };
+
+    ///structure of arrays of T components with the part of std::vector interface storages use,
+    ///member arrays are allocated from memory resource and aligned to cache line so they can be loaded with aligned
+    ///SIMD loads, elements are accessed through SoARef proxies and whole members through Field<&T::member>()
+    template<typename T> requires SoAComponent<T>
+    class SoAVector
+    {
+        using Pointers = typename Detail::SoAPointers<T>::Type;
+        using ConstPointers = typename Detail::SoAPointers<const T>::Type;
+
+        public:
+            static constexpr std::size_t Alignment{64};
+            ///bytes one element takes in member arrays
+            static constexpr std::size_t ElementSize = []<std::size_t ...I>(std::index_sequence<I...>){
+                return (sizeof(Detail::SoAField<T, I>) + ...);
+            }(std::make_index_sequence<Detail::SoAFieldsCount<T>>{});
+
+            using value_type = T;
+            using reference = SoARef<T>;
+            using const_reference = SoARef<const T>;
+
+            explicit SoAVector(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : _resource(resource) {}
+            ~SoAVector();
+
+            SoAVector(const SoAVector&) = delete;
+            SoAVector& operator=(const SoAVector&) = delete;
+
+            std::size_t size() const { return _size; }
+            std::size_t capacity() const { return _capacity; }
+            bool empty() const { return _size == 0; }
+
+            void reserve(std::size_t capacity);
+            void shrink_to_fit() { if(_capacity > _size) Reallocate(_size); }
+            void clear() { _size = 0; }
+
+            ///constructs T from args and scatters it into member arrays
+            template<typename ...Args>
+            SoARef<T> emplace_back(Args&&... args);
+            void push_back(const T& value) { emplace_back(value); }
+            void pop_back() { --_size; }
+
+            SoARef<T> operator[](std::size_t index) { return SoARef<T>{Offset(_fields, index)}; }
+            SoARef<const T> operator[](std::size_t index) const { return SoARef<const T>{Offset(ConstFields(), index)}; }
+
+            SoARef<T> back() { return (*this)[_size - 1]; }
+            SoARef<const T> back() const { return (*this)[_size - 1]; }
+
+            ///all instances of one member, Field<&Particle::x>()
+            template<auto Member>
+            auto Field() { return Slice(0, _size).template Field<Member>(); }
+
+            template<auto Member>
+            auto Field() const { return Slice(0, _size).template Field<Member>(); }
+
+            SoASpan<T> Slice(std::size_t begin, std::size_t count) { return {Offset(_fields, begin), count}; }
+            SoASpan<const T> Slice(std::size_t begin, std::size_t count) const { return {Offset(ConstFields(), begin), count}; }
+
+        private:
+            ///moves member arrays to arrays of given capacity (at least size)
+            void Reallocate(std::size_t capacity);
+
+            template<typename Fields>
+            static Fields Offset(const Fields& fields, std::size_t index)
+            {
+                return std::apply([index](auto... field){ return Fields{(field + index)...}; }, fields);
+            }
+
+            ConstPointers ConstFields() const
+            {
+                return std::apply([](auto... field){ return ConstPointers{field...}; }, _fields);
+            }
+
+            std::pmr::memory_resource* _resource;
+            Pointers _fields{};
+            std::size_t _size{0};
+            std::size_t _capacity{0};
+    };
+
+    namespace Detail
+    {
+        template<typename T>
+        struct ComponentLayout
+        {
+            using Instances = std::pmr::vector<T>;
+            using Ref = T&;
+        };
+
+        template<SoAComponent T>
+        struct ComponentLayout<T>
+        {
+            using Instances = SoAVector<std::remove_const_t<T>>;
+            using Ref = SoARef<T>;
+        };
+    }
+
+    ///what storages keep instances of T in, SoAVector for components with SoAFields
+    template<typename T>
+    using ComponentInstances = typename Detail::ComponentLayout<T>::Instances;
+
+    ///reference to stored component, const T for read only one
+    template<typename T>
+    using ComponentRef = typename Detail::ComponentLayout<T>::Ref;
+}
+
+#include "Impl/SoA_impl.tpp"
+
+#endif
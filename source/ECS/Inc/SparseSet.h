@@ -0,0 +1,73 @@
+#ifndef MYECS_SPARSESET_H
+#define MYECS_SPARSESET_H
+
+#include <Inc/Entity.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <memory>
+#include <vector>
+
+namespace MyECS
+{
+    ///paged sparse set of entities, sparse pages map entity index to its index in the dense array,
+    ///dense array keeps entities packed so it can be kept in step with component instances,
+    ///handles of other generations of the same slot aren't contained
+    template<std::size_t page_size = 4096> requires (std::has_single_bit(page_size))
+    class SparseSet
+    {
+        public:
+            bool Contains(Entity) const;
+
+            ///returns dense index of the entity, entity has to be in the set
+            std::size_t IndexOf(Entity) const;
+
+            ///appends entity to the dense array and returns its dense index
+            std::size_t Insert(Entity);
+
+            ///swap-and-pop removal, returns dense index which the removed entity occupied
+            ///(last entity of the dense array is moved to it)
+            std::size_t Erase(Entity);
+
+            ///exchanges positions of two dense entries
+            void Swap(std::size_t lhs, std::size_t rhs);
+
+            void Reserve(std::size_t);
+
+            ///removes all entities, pages are kept
+            void Clear();
+
+            ///releases spare dense capacity and sparse pages without entities
+            void ShrinkToFit();
+
+            std::size_t Size() const { return _dense.size(); }
+            bool Empty() const { return _dense.empty(); }
+            const std::vector<Entity>& GetEntities() const { return _dense; }
+
+            ///bytes of allocated sparse pages, pages index and dense array
+            std::size_t MemoryUsage() const
+            {
+                std::size_t pages{0};
+                for(const auto& page : _sparse)
+                    pages += page ? 1 : 0;
+
+                return pages * sizeof(Page) + _sparse.capacity() * sizeof(std::unique_ptr<Page>) + _dense.capacity() * sizeof(Entity);
+            }
+
+        private:
+            static constexpr uint32_t _tombstone = UINT32_MAX;
+            static constexpr std::size_t _pageShift = std::bit_width(page_size) - 1;
+            static constexpr std::size_t _pageMask = page_size - 1;
+
+            using Page = std::array<uint32_t, page_size>;
+
+            uint32_t& AssurePage(Entity index);
+
+            std::vector<std::unique_ptr<Page>> _sparse;
+            std::vector<Entity> _dense;
+    };
+}
+
+#include "Impl/SparseSet_impl.tpp"
+
+#endif
@@ -3,36 +3,79 @@
 
 #include <Inc/Bits.h>
 #include <Inc/Entity.h>
-#include <unordered_map>
+#include <Inc/SparseSet.h>
+#include <span>
 
 namespace MyECS
 {
     template<typename ...Args>
     struct SystemComponents {};
 
+    ///access wrappers for SystemComponents, bare component type is treated as written,
+    ///e.g. SystemComponents<Read<Transform>, Write<Velocity>, Health>
+    template<typename T>
+    struct Read {};
+
+    template<typename T>
+    struct Write {};
+
+    template<typename T>
+    struct ComponentAccess { using Type = T; static constexpr bool ReadOnly = false; };
+
+    template<typename T>
+    struct ComponentAccess<Read<T>> { using Type = T; static constexpr bool ReadOnly = true; };
+
+    template<typename T>
+    struct ComponentAccess<Write<T>> { using Type = T; static constexpr bool ReadOnly = false; };
+
+    template<typename T>
+    using UnwrapComponent = typename ComponentAccess<T>::Type;
+
+    template<size_t, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
+    class Scheduler;
+
     template<size_t components_capacity, typename BitsStorageType> requires std::is_unsigned_v<BitsStorageType>
     class System
     {
-        template<size_t, size_t, typename BitsStorageType_> requires std::is_unsigned_v<BitsStorageType_>
+        template<size_t, size_t, typename BitsStorageType_, typename> requires std::is_unsigned_v<BitsStorageType_>
         friend class EntityManager;
 
+        friend class Scheduler<components_capacity, BitsStorageType>;
+
         protected:
             template<typename ...ManagedComponentsTypes>
             System(SystemComponents<ManagedComponentsTypes...>&&);
 
+        public:
+            virtual ~System() = default;
+
+        protected:
             virtual void OnEntityAdditionAction(Entity) {};
             virtual void OnEntityRemovalAction(Entity) {};
 
-            const std::unordered_map<Entity, Entity>& GetSystemEntities() const { return _managedEntities; }
+            ///called once per frame by the scheduler, systems without read/write conflicts run concurrently
+            virtual void OnUpdate() {};
+
+            ///entities managed by the system packed in memory, order changes when entities leave the system
+            const std::vector<Entity>& GetSystemEntities() const { return _managedEntities.GetEntities(); }
 
         private:
             void OnEntityUpdate(Entity, const Bits<BitsStorageType, components_capacity>& entityComponentsBits);
             void OnEntityAdd(Entity, const Bits<BitsStorageType, components_capacity>& entityComponentsBits);
             void OnEntityRemove(Entity);
 
+            ///batched OnEntityAdd for entities which all have the same components
+            void OnEntitiesAdd(std::span<const Entity>, const Bits<BitsStorageType, components_capacity>& entitiesComponentsBits);
+
+            ///batched OnEntityUpdate, entityComponentsBits(entity) returns components of given entity
+            template<typename ComponentsBitsGetter>
+            void OnEntitiesUpdate(std::span<const Entity>, ComponentsBitsGetter&& entityComponentsBits);
+
         private:
-            std::unordered_map<Entity, Entity> _managedEntities;
+            SparseSet<> _managedEntities;
             Bits<BitsStorageType, components_capacity> _managedComponentsBits;
+            Bits<BitsStorageType, components_capacity> _readComponentsBits;
+            Bits<BitsStorageType, components_capacity> _writeComponentsBits;
     };
 }
 
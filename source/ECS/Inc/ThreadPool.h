@@ -0,0 +1,106 @@
+#ifndef MYECS_THREADPOOL_H
+#define MYECS_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MyECS
+{
+    ///work stealing thread pool, every worker has its own queue, tasks submitted from a worker go to its queue,
+    ///idle workers steal from the front of the other queues
+    class ThreadPool
+    {
+        public:
+            using Task = std::function<void()>;
+
+            explicit ThreadPool(std::size_t threadsCount = std::max(1u, std::thread::hardware_concurrency()));
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            void Submit(Task task);
+
+            ///runs one pending task on the calling thread, returns false if there was nothing to run
+            bool TryRunPendingTask();
+
+            ///helps executing pending tasks until predicate is satisfied
+            template<typename Predicate>
+            void WaitUntil(Predicate&& done)
+            {
+                while(!done())
+                    if(!TryRunPendingTask())
+                        std::this_thread::yield();
+            }
+
+            ///splits [0, count) into ranges of grainSize elements and calls fn(begin, end) for each of them on the pool,
+            ///returns when all ranges are processed, calling thread takes part in processing
+            template<typename Fn>
+            void ParallelFor(std::size_t count, std::size_t grainSize, Fn&& fn)
+            {
+                ParallelFor(0, count, grainSize, std::forward<Fn>(fn));
+            }
+
+            ///same as above, but first range ends at firstEnd (lets callers align ranges to cache lines)
+            template<typename Fn>
+            void ParallelFor(std::size_t firstEnd, std::size_t count, std::size_t grainSize, Fn&& fn)
+            {
+                grainSize = std::max<std::size_t>(grainSize, 1);
+                firstEnd = std::min(firstEnd, count);
+
+                std::atomic<std::size_t> remaining{0};
+                std::size_t begin{0};
+
+                if(firstEnd > 0)
+                {
+                    ++remaining;
+                    Submit([&fn, &remaining, firstEnd]{ fn(std::size_t{0}, firstEnd); --remaining; });
+                    begin = firstEnd;
+                }
+
+                for(; begin<count; begin += grainSize)
+                {
+                    const std::size_t end = std::min(begin + grainSize, count);
+                    ++remaining;
+                    Submit([&fn, &remaining, begin, end]{ fn(begin, end); --remaining; });
+                }
+
+                WaitUntil([&remaining]{ return remaining == 0; });
+            }
+
+            std::size_t ThreadsCount() const { return _workers.size(); }
+
+        private:
+            struct Queue
+            {
+                std::mutex mutex;
+                std::deque<Task> tasks;
+            };
+
+            void WorkerLoop(std::size_t index);
+            bool TryPop(std::size_t index, Task&);
+            bool TrySteal(std::size_t index, Task&);
+
+            std::vector<std::unique_ptr<Queue>> _queues;
+            std::vector<std::thread> _workers;
+
+            std::atomic<std::size_t> _nextQueue{0};
+            std::atomic<std::size_t> _pendingTasks{0};
+            std::atomic<bool> _stop{false};
+
+            std::mutex _sleepMutex;
+            std::condition_variable _sleepCondition;
+
+            static thread_local ThreadPool* _currentPool;
+            static thread_local std::size_t _currentIndex;
+    };
+}
+
+#endif
@@ -18,6 +18,20 @@ namespace MyECS
             private:
                 static std::atomic<std::size_t> counter;
         };
+
+        ///ids of singleton types, counted apart from component ids so singletons don't use up components capacity
+        struct SingletonID
+        {
+            template<typename T>
+            static std::size_t get()
+            {
+                static std::size_t ID = counter++;
+                return ID;
+            }
+
+            private:
+                static std::atomic<std::size_t> counter;
+        };
 }
 
 #endif
\ No newline at end of file
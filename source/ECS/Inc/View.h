@@ -0,0 +1,150 @@
+#ifndef MYECS_VIEW_H
+#define MYECS_VIEW_H
+
+#include <Inc/ComponentStorage.h>
+#include <algorithm>
+#include <execution>
+#include <iterator>
+#include <tuple>
+
+namespace MyECS
+{
+    namespace Detail
+    {
+        ///stands in for storage of tag component in views, tags are tested in entities' components bits
+        template<typename T>
+        struct TagFilter {};
+
+        template<typename Manager, typename T>
+        struct ViewStorage
+        {
+            using Type = typename Manager::template ComponentsStorageType<T, false>;
+        };
+
+        template<typename Manager, TagComponent T>
+        struct ViewStorage<Manager, T>
+        {
+            using Type = TagFilter<T>;
+        };
+
+        ///element of the view's row, none for tags
+        template<typename T>
+        using ViewRef = std::conditional_t<TagComponent<T>, std::tuple<>, std::tuple<ComponentRef<T>>>;
+    }
+
+    ///view over entities which have all Args components (non thread safe storages), matching entities are cached
+    ///and collected by walking the smallest storage and checking membership of the others through their sparse sets,
+    ///cache is rebuilt when any of the storages was modified since it was collected,
+    ///tag components only filter entities and yield no reference, View<Position, EnemyTag> yields (Entity, Position&)
+    template<typename Manager, typename ...Args>
+    class View
+    {
+        template<typename T>
+        using StorageType = typename Detail::ViewStorage<Manager, T>::Type;
+
+        using Row = decltype(std::tuple_cat(std::declval<std::tuple<Entity>>(), std::declval<Detail::ViewRef<Args>>()...));
+
+        public:
+            class Iterator
+            {
+                public:
+                    using iterator_category = std::random_access_iterator_tag;
+                    using difference_type = std::ptrdiff_t;
+                    using value_type = Row;
+                    using reference = value_type;
+                    using pointer = void;
+
+                    Iterator() = default;
+                    Iterator(const View* view, std::size_t index) : _view(view), _index(index) {}
+
+                    reference operator*() const { return _view->Get(_view->_entities[_index]); }
+                    reference operator[](difference_type n) const { return *(*this + n); }
+
+                    Iterator& operator++() { ++_index; return *this; }
+                    Iterator operator++(int) { auto tmp = *this; ++_index; return tmp; }
+                    Iterator& operator--() { --_index; return *this; }
+                    Iterator operator--(int) { auto tmp = *this; --_index; return tmp; }
+
+                    Iterator& operator+=(difference_type n) { _index += n; return *this; }
+                    Iterator& operator-=(difference_type n) { _index -= n; return *this; }
+                    friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+                    friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+                    friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+                    friend difference_type operator-(const Iterator& lhs, const Iterator& rhs)
+                    { return static_cast<difference_type>(lhs._index) - static_cast<difference_type>(rhs._index); }
+
+                    friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs._index == rhs._index; }
+                    friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) { return lhs._index <=> rhs._index; }
+
+                private:
+                    const View* _view{nullptr};
+                    std::size_t _index{0};
+            };
+
+            explicit View(const Manager* manager);
+
+            Iterator begin();
+            Iterator end();
+
+            std::size_t Size();
+            const std::vector<Entity>& GetEntities();
+
+            ///calls fn(Entity, Args&...) for every matching entity (tags left out), SoA components are passed as SoARef<Args>
+            template<typename Fn>
+            void Each(Fn&& fn);
+
+            ///calls fn(Entity, Args&...) for every matching entity with given std::execution policy,
+            ///fn has to be safe to call concurrently for different entities
+            template<typename ExecutionPolicy, typename Fn>
+            requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+            void Each(ExecutionPolicy&& policy, Fn&& fn);
+
+            ///rebuilds cached matching entities
+            void Refresh();
+
+        private:
+            Row Get(Entity entity) const
+            {
+                return std::tuple_cat(std::tuple<Entity>{entity}, Ref<Args>(entity)...);
+            }
+
+            template<typename T>
+            Detail::ViewRef<T> Ref(Entity entity) const
+            {
+                if constexpr(TagComponent<T>)
+                    return {};
+                else
+                    return Detail::ViewRef<T>{std::get<StorageType<T>*>(_storages)->GetByEntity(entity)};
+            }
+
+            ///storage of T, tags have none
+            template<typename T>
+            StorageType<T>* Storage() const
+            {
+                if constexpr(TagComponent<T>)
+                    return nullptr;
+                else
+                    return _manager->template StorageCaster<T, false>();
+            }
+
+            template<typename T>
+            bool Contains(Entity entity) const;
+
+            ///version of storage of T, tags share the version of all tags of the manager
+            template<typename T>
+            std::size_t Version() const;
+
+            bool IsStale() const;
+            bool AllStoragesExist() const { return ((TagComponent<Args> || std::get<StorageType<Args>*>(_storages) != nullptr) && ...); }
+
+            const Manager* _manager;
+            std::tuple<StorageType<Args>*...> _storages;
+            std::array<std::size_t, sizeof...(Args)> _versions;
+            std::vector<Entity> _entities;
+            bool _valid{false};
+    };
+}
+
+#include "Impl/View_impl.tpp"
+
+#endif
@@ -3,6 +3,10 @@
 #include <Inc/EntityManager.h>
 #include <gtest/gtest.h>
 #include <Inc/System.h>
+#include <execution>
+#include <atomic>
+#include <thread>
+#include <memory_resource>
 
 #include <fmt/core.h>
 
@@ -113,6 +117,73 @@ TEST(EntityCreationTest, CreateEntitiesTest)
     }
 }
 
+TEST(EntityCreationTest, StaleHandlesAreNotAlive)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+
+    const auto removed = man->CreateEntity<false, int>(1);
+    man->RemoveEntity(removed);
+    const auto reused = man->CreateEntity<false, int>(2);
+
+    ASSERT_EQ(MyECS::GetEntityIndex(reused), MyECS::GetEntityIndex(removed));
+    ASSERT_NE(reused, removed);
+    ASSERT_FALSE(man->IsAlive(removed));
+    ASSERT_TRUE(man->IsAlive(reused));
+    ASSERT_FALSE(man->IsAlive(MyECS::InvalidEntity));
+
+    ASSERT_FALSE(man->GetView<int>().GetEntities().empty());
+    for(const auto [entity, value] : man->GetView<int>())
+    {
+        ASSERT_EQ(entity, reused);
+        ASSERT_EQ(value, 2);
+    }
+}
+
+TEST(EntityCreationTest, AliveEntitiesStayPacked)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    std::vector<MyECS::Entity> entities; entities.reserve(ENTITY_COUNT/4);
+
+    for(uint32_t i{0}; i<ENTITY_COUNT/4; ++i)
+        entities.push_back(man->CreateEntity<false, int>(static_cast<int>(i)));
+
+    for(std::size_t i{0}; i<entities.size(); i += 3)
+        man->RemoveEntity(entities[i]);
+
+    const auto alive = man->GetAliveEntities();
+    ASSERT_EQ(alive.size(), man->AliveEntitiesCount());
+    ASSERT_EQ(alive.size(), entities.size() - (entities.size() + 2) / 3);
+
+    for(const auto entity : alive)
+        ASSERT_TRUE(man->IsAlive(entity));
+
+    const auto reused = man->CreateEntity<false, int>(0);
+    ASSERT_EQ(man->GetAliveEntities().back(), reused);
+}
+
+TEST(EntityCreationTest, EntityPagesFollowAliveEntities)
+{
+    MyECS::EntityManager<MyECS::MaxEntitiesCount, COMPONENTS_COUNT, BitsStorageType> man;
+    ASSERT_EQ(man.EntityPagesCount(), 0);
+
+    const auto entities = man.CreateEntities<false, int>(10000, [](std::size_t i){ return std::tuple<int>{static_cast<int>(i)}; });
+    ASSERT_EQ(man.EntityPagesCount(), 3);
+
+    for(std::size_t i{0}; i<4096; ++i)
+        man.RemoveEntity(entities[i]);
+
+    ASSERT_EQ(man.EntityPagesCount(), 2);
+    ASSERT_FALSE(man.IsAlive(entities[0]));
+    ASSERT_TRUE(man.IsAlive(entities[4096]));
+
+    const auto reused = man.CreateEntity<false, int>(-1);
+    ASSERT_EQ(man.EntityPagesCount(), 3);
+    ASSERT_EQ(MyECS::GetEntityIndex(reused), 4095);
+    ASSERT_FALSE(man.IsAlive(entities[4095]));
+    ASSERT_TRUE((man.HasComponent<int>(reused)));
+    ASSERT_EQ(std::get<0>(man.GetEntityComponents<int>(reused)), -1);
+}
+
 TEST_F(EntityManagerTest, HasComponentTest)
 {
     for(const auto entity : entities)
@@ -193,6 +264,220 @@ TEST_F(EntityManagerTest, AddEntityComponents)
     }
 }
 
+TEST(BitsTest, OnesAndWideOperations)
+{
+    MyECS::Bits<BitsStorageType, COMPONENTS_COUNT> small;
+    small.Set(0); small.Set(7); small.Set(15);
+    ASSERT_EQ((std::vector<uint32_t>(small.Ones().begin(), small.Ones().end())), (std::vector<uint32_t>{0, 7, 15}));
+
+    MyECS::Bits<BitsStorageType, ENTITY_COUNT> lhs, rhs;
+    const std::vector<uint32_t> lhsOnes{3, 64, 255, 4097, ENTITY_COUNT - 1};
+    for(const auto bit : lhsOnes)
+        lhs.Set(bit);
+
+    ASSERT_EQ((std::vector<uint32_t>(lhs.Ones().begin(), lhs.Ones().end())), lhsOnes);
+    ASSERT_EQ(lhs.IsAndNonZero(rhs), false);
+
+    rhs.Set(ENTITY_COUNT - 1);
+    ASSERT_EQ(lhs.IsAndNonZero(rhs), true);
+    ASSERT_EQ(rhs.DoesAndEqualThis(lhs), true);
+    ASSERT_EQ(lhs.DoesAndEqualThis(rhs), false);
+
+    rhs |= lhs;
+    ASSERT_EQ(rhs == lhs, true);
+
+    rhs.Reset(4097);
+    rhs &= lhs;
+    ASSERT_EQ(rhs == lhs, false);
+    ASSERT_EQ(lhs.DoesAndEqualThis(rhs), false);
+    ASSERT_EQ(std::distance(rhs.Ones().begin(), rhs.Ones().end()), lhsOnes.size() - 1);
+}
+
+TEST(ComponentsStorageTest, SwapAndPopKeepsEntityMapping)
+{
+    MyECS::ComponentsStorage<COMPONENTS_COUNT, BitsStorageType, int, false> storage;
+
+    for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; ++entity)
+        storage.AddComponentInstance(entity, static_cast<int>(entity));
+
+    for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; entity += 2)
+        storage.DeleteComponentInstance(entity);
+
+    ASSERT_EQ(storage.Size(), ENTITY_COUNT/2);
+
+    for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; ++entity)
+    {
+        ASSERT_EQ(storage.Contains(entity), entity % 2 == 1);
+        if(storage.Contains(entity))
+        {
+            ASSERT_EQ(storage.GetByEntity(entity), static_cast<int>(entity));
+        }
+    }
+}
+
+struct SoAParticle
+{
+    float x{0.0f};
+    float y{0.0f};
+    int id{0};
+};
+
+template<>
+struct MyECS::SoAFields<SoAParticle>
+{
+    static constexpr auto Members = std::make_tuple(&SoAParticle::x, &SoAParticle::y, &SoAParticle::id);
+};
+
+///converts to SoAParticle by throwing, so construction of SoA instance fails
+struct ThrowingParticleSource
+{
+    operator SoAParticle() const { throw std::runtime_error("particle"); }
+};
+
+TEST(ComponentsStorageTest, ThrowingConstructionLeavesStorageIntact)
+{
+    MyECS::ComponentsStorage<COMPONENTS_COUNT, BitsStorageType, std::string, false> storage;
+    MyECS::ComponentsStorage<COMPONENTS_COUNT, BitsStorageType, std::string, true> threadSafeStorage;
+
+    storage.EmplaceComponentInstance(0, "zero");
+    ASSERT_THROW(storage.EmplaceComponentInstance(1, std::string::npos, 'a'), std::length_error);
+    ASSERT_FALSE(storage.Contains(1));
+    ASSERT_EQ(storage.Size(), 1);
+    storage.EmplaceComponentInstance(2, "two");
+    ASSERT_EQ(storage.GetByEntity(2), "two");
+
+    threadSafeStorage.EmplaceComponentInstance(0, "zero");
+    ASSERT_THROW(threadSafeStorage.EmplaceComponentInstance(1, std::string::npos, 'a'), std::length_error);
+    ASSERT_FALSE(threadSafeStorage.Contains(1));
+    ASSERT_EQ(threadSafeStorage.Size(), 1);
+
+    MyECS::ComponentsStorage<COMPONENTS_COUNT, BitsStorageType, SoAParticle, false> soaStorage;
+
+    soaStorage.EmplaceComponentInstance(0, SoAParticle{0.0f, 0.0f, 0});
+    ASSERT_THROW(soaStorage.EmplaceComponentInstance(1, ThrowingParticleSource{}), std::runtime_error);
+    ASSERT_FALSE(soaStorage.Contains(1));
+    ASSERT_EQ(soaStorage.Size(), 1);
+    soaStorage.EmplaceComponentInstance(2, SoAParticle{2.0f, 2.0f, 2});
+    ASSERT_EQ(soaStorage.GetByEntity(2).Get<&SoAParticle::id>(), 2);
+}
+
+TEST(ComponentsStorageTest, ConcurrentReadersAndWriter)
+{
+    MyECS::ComponentsStorage<COMPONENTS_COUNT, BitsStorageType, int, true> storage;
+
+    for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; ++entity)
+        storage.AddComponentInstance(entity, 0);
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for(int i{0}; i<2; ++i)
+        readers.emplace_back([&storage, &done]{
+            while(!done)
+                for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; entity += 1021)
+                    ASSERT_GE(storage.Read(entity, [](const int& value){ return value; }), 0);
+        });
+
+    for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; ++entity)
+        storage.Write(entity, [](int& value){ ++value; });
+
+    done = true;
+    for(auto& reader : readers)
+        reader.join();
+
+    for(MyECS::Entity entity{0}; entity<ENTITY_COUNT; ++entity)
+        ASSERT_EQ(storage.GetByEntity(entity), 1);
+}
+
+TEST(GroupTest, GroupedInstancesStayPackedAcrossStructuralChanges)
+{
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+    auto man = std::make_unique<Manager>();
+    std::vector<MyECS::Entity> entities; entities.reserve(ENTITY_COUNT/4);
+
+    for(uint32_t i{0}; i<ENTITY_COUNT/8; ++i)
+        entities.push_back(man->CreateEntity<false, CustomComponent1, int>({}, static_cast<int>(i)));
+
+    // entities present before the group is created are joined to it
+    ASSERT_TRUE((man->CreateGroup<int, float>()));
+    ASSERT_FALSE((man->CreateGroup<float, CustomComponent1>()));
+
+    for(uint32_t i{ENTITY_COUNT/8}; i<ENTITY_COUNT/4; ++i)
+        entities.push_back(man->CreateEntity<false, CustomComponent1, int>({}, static_cast<int>(i)));
+
+    Manager::CommandBufferType buffer;
+    for(const auto entity : entities)
+        if(entity % 4 == 0)
+            man->AddComponents<false, float>(entity, static_cast<float>(entity));
+        else if(entity % 4 == 2)
+            buffer.AddComponents(entity, static_cast<float>(entity));
+    man->Flush(buffer);
+
+    for(const auto entity : entities)
+        if(entity % 4 == 0)
+            man->DetachComponents<int>(entity);
+        else if(entity % 3 == 0)
+            man->RemoveEntity(entity);
+
+    const auto checkGroup = [&man]{
+        std::size_t count{0};
+        man->EachInGroup<int, float>([&count](MyECS::Entity entity, int& value, float& weight){
+            ASSERT_EQ(value, static_cast<int>(entity));
+            ASSERT_EQ(weight, static_cast<float>(entity));
+            ++count;
+        });
+        ASSERT_EQ(count, (man->GetView<int, float>().Size()));
+    };
+
+    checkGroup();
+    ASSERT_EQ((man->GetView<int, float>().Size()), ENTITY_COUNT/16 - (ENTITY_COUNT/16 + 1)/3);
+
+    man->Compact<CustomComponent1>();
+    checkGroup();
+
+    std::vector<std::byte> snapshot;
+    ASSERT_TRUE(man->SaveSnapshot(snapshot));
+    ASSERT_TRUE(man->LoadSnapshot(snapshot));
+    checkGroup();
+}
+
+TEST(ViewTest, IterateEntitiesWithComponents)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+
+    for(uint32_t i{0}; i<ENTITY_COUNT/4; ++i)
+    {
+        if(i % 3 == 0)
+            man->CreateEntity<false, CustomComponent1, int>({}, static_cast<int>(i));
+        else
+            man->CreateEntity<false, int>(static_cast<int>(i));
+    }
+
+    auto view = man->GetView<CustomComponent1, int>();
+    ASSERT_EQ(view.Size(), (ENTITY_COUNT/4 + 2)/3);
+
+    for(auto [entity, c1, value] : view)
+    {
+        ASSERT_EQ(value, static_cast<int>(entity));
+        c1.transposed = true;
+    }
+
+    std::atomic<std::size_t> count{0};
+    view.Each(std::execution::par, [&count](MyECS::Entity, const CustomComponent1& c1, int&){
+        if(c1.transposed) ++count;
+    });
+    ASSERT_EQ(count, view.Size());
+
+    man->AddComponents<false, CustomComponent1>(1, {});
+    man->RemoveEntity(0);
+    ASSERT_EQ(view.Size(), (ENTITY_COUNT/4 + 2)/3);
+    ASSERT_EQ(std::get<0>(*view.begin()) != 0, true);
+
+    auto emptyView = man->GetView<CustomComponent1, CustomComponent4>();
+    ASSERT_EQ(emptyView.Size(), 0);
+    man->AddComponents<false, CustomComponent4>(1, {});
+    ASSERT_EQ(emptyView.Size(), 1);
+}
+
 TEST_F(EntityManagerTest, GetComponentsTest)
 {
     /*
@@ -206,6 +491,947 @@ TEST_F(EntityManagerTest, GetComponentsTest)
 }
 
 
+TEST(ParallelEachTest, VisitsEveryComponentOnce)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    for(uint32_t i{0}; i<ENTITY_COUNT/4; ++i)
+        man->CreateEntity<false, CustomComponent1, int>({}, 0);
+
+    man->ParallelEach<CustomComponent1>([](MyECS::Entity entity, CustomComponent1& c1){
+        c1.mat4[0] = static_cast<float>(entity);
+    }, 100);
+
+    man->ParallelEach<int>([](std::span<const MyECS::Entity> entities, std::span<int> values){
+        for(std::size_t i{0}; i<values.size(); ++i)
+            values[i] += static_cast<int>(entities[i]) + 1;
+    });
+
+    // 68 byte components, every chunk but the first one starts at cache line boundary
+    std::mutex chunksMutex;
+    std::size_t chunks{0}, unalignedChunks{0};
+    man->ParallelEach<CustomComponent1>([&](std::span<const MyECS::Entity>, std::span<CustomComponent1> chunk){
+        std::lock_guard<std::mutex> lock{chunksMutex};
+        ++chunks;
+        if(reinterpret_cast<std::uintptr_t>(chunk.data()) % 64 != 0)
+            ++unalignedChunks;
+    }, 100);
+    ASSERT_GT(chunks, 1);
+    ASSERT_LE(unalignedChunks, 1);
+
+    for(const auto& [entity, c1, value] : man->GetView<CustomComponent1, int>())
+    {
+        ASSERT_EQ(c1.mat4[0], static_cast<float>(entity));
+        ASSERT_EQ(value, static_cast<int>(entity) + 1);
+    }
+}
+
+using TestSystem = MyECS::System<COMPONENTS_COUNT, BitsStorageType>;
+
+template<typename ...Components>
+struct OrderRecordingSystem : public TestSystem
+{
+    OrderRecordingSystem(std::atomic<int>& counter, int& order)
+        : TestSystem(MyECS::SystemComponents<Components...>{}), counter(counter), order(order) {}
+
+    void OnUpdate() override { order = counter++; }
+
+    std::atomic<int>& counter;
+    int& order;
+};
+
+TEST(SchedulerTest, SystemsDependOnConflictingComponents)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    std::atomic<int> counter{0};
+    std::array<int, 4> order{};
+
+    man->CreateSystem<OrderRecordingSystem<MyECS::Write<CustomComponent1>>>
+        (MyECS::SystemComponents<MyECS::Write<CustomComponent1>>{}, counter, order[0]);
+    man->CreateSystem<OrderRecordingSystem<MyECS::Read<CustomComponent1>>>
+        (MyECS::SystemComponents<MyECS::Read<CustomComponent1>>{}, counter, order[1]);
+    man->CreateSystem<OrderRecordingSystem<MyECS::Read<CustomComponent3>>>
+        (MyECS::SystemComponents<MyECS::Read<CustomComponent3>>{}, counter, order[2]);
+    man->CreateSystem<OrderRecordingSystem<MyECS::Read<CustomComponent1>, CustomComponent3>>
+        (MyECS::SystemComponents<MyECS::Read<CustomComponent1>, CustomComponent3>{}, counter, order[3]);
+
+    for(int frame{0}; frame<8; ++frame)
+    {
+        counter = 0;
+        man->UpdateSystems();
+
+        ASSERT_EQ(counter, 4);
+        ASSERT_LT(order[0], order[1]);
+        ASSERT_LT(order[0], order[3]);
+        ASSERT_LT(order[2], order[3]);
+    }
+
+    const auto& scheduler = man->GetScheduler();
+    ASSERT_EQ(scheduler.GetDependencies(1), std::vector<std::size_t>{0});
+    ASSERT_EQ(scheduler.GetDependencies(2).empty(), true);
+    ASSERT_EQ(scheduler.GetDependencies(3), (std::vector<std::size_t>{0, 2}));
+    ASSERT_EQ(scheduler.GetTimings().size(), 4);
+    ASSERT_EQ(scheduler.GetCriticalPath().empty(), false);
+}
+
+struct CountingSystem : public TestSystem
+{
+    CountingSystem() : TestSystem(MyECS::SystemComponents<CustomComponent2, int>{}) {}
+
+    void OnEntityAdditionAction(MyECS::Entity) override { ++count; }
+    void OnEntityRemovalAction(MyECS::Entity) override { --count; }
+
+    int count{0};
+};
+
+TEST(CommandBufferTest, FlushAppliesRecordedCommandsInOrder)
+{
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+    auto man = std::make_unique<Manager>();
+    auto* system = man->CreateSystem<CountingSystem>(MyECS::SystemComponents<CustomComponent2, int>{});
+
+    for(uint32_t i{0}; i<ENTITY_COUNT/16; ++i)
+        man->CreateEntity<false, int>(static_cast<int>(i));
+
+    std::vector<Manager::CommandBufferType> buffers(8);
+    man->GetThreadPool().ParallelFor(buffers.size(), 1, [&buffers](std::size_t begin, std::size_t end){
+        for(std::size_t b{begin}; b<end; ++b)
+            for(MyECS::Entity entity(b); entity<ENTITY_COUNT/16; entity += 8)
+            {
+                buffers[b].AddComponents(entity, CustomComponent2{});
+                if(entity % 3 == 0)
+                    buffers[b].RemoveEntity(entity);
+
+                const auto created = buffers[b].CreateEntity(std::string("created"));
+                buffers[b].AddComponents(created, CustomComponent2{}, static_cast<int>(-1));
+                buffers[b].DetachComponents<std::string>(created);
+            }
+    });
+
+    ASSERT_EQ(man->HasComponent<CustomComponent2>(1), false);
+    man->Flush(buffers);
+
+    for(const auto& buffer : buffers)
+        ASSERT_EQ(buffer.Empty(), true);
+
+    const int removed = (ENTITY_COUNT/16 + 2)/3;
+    ASSERT_EQ(system->count, ENTITY_COUNT/16 - removed + ENTITY_COUNT/16);
+    ASSERT_EQ((man->GetView<CustomComponent2, int>().Size()), system->count);
+    ASSERT_EQ(man->GetView<std::string>().Size(), 0);
+
+    for(const auto& [entity, c2, value] : man->GetView<CustomComponent2, int>())
+        ASSERT_EQ(c2.str, "str");
+}
+
+TEST(CommandBufferTest, CommandsOfRemovedEntitiesAreDropped)
+{
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+    auto man = std::make_unique<Manager>();
+
+    const auto removed = man->CreateEntity<false, int>(1);
+    const auto kept = man->CreateEntity<false, int>(2);
+
+    std::vector<Manager::CommandBufferType> buffers(2);
+    buffers[0].RemoveEntity(removed);
+    buffers[1].RemoveEntity(removed);
+    buffers[1].AddComponents(removed, std::string("stale"));
+    buffers[1].AddComponents(kept, std::string("kept"));
+    man->Flush(buffers);
+
+    ASSERT_FALSE(man->IsAlive(removed));
+    ASSERT_EQ(man->AliveEntitiesCount(), 1);
+    ASSERT_EQ(man->GetView<std::string>().Size(), 1);
+}
+
+TEST(CommandBufferTest, RepeatedAddsAndDetachesOfBuffersAreResolvedOnFlush)
+{
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+    auto man = std::make_unique<Manager>();
+
+    const auto detached = man->CreateEntity<false, int, std::string>(1, "detached");
+    const auto added = man->CreateEntity<false, int>(2);
+    const auto other = man->CreateEntity<false, int, std::string>(3, "other");
+
+    std::vector<Manager::CommandBufferType> buffers(2);
+    for(auto& buffer : buffers)
+        buffer.DetachComponents<std::string>(detached);
+    buffers[0].AddComponents(added, std::string("first"));
+    buffers[1].AddComponents(added, std::string("second"));
+    man->Flush(buffers);
+
+    ASSERT_FALSE(man->HasComponent<std::string>(detached));
+    ASSERT_EQ(man->GetView<std::string>().Size(), 2);
+    ASSERT_EQ(std::get<0>(man->GetEntityComponents<std::string>(added)), "second");
+    ASSERT_EQ(std::get<0>(man->GetEntityComponents<std::string>(other)), "other");
+    ASSERT_EQ(man->GetComponents<std::string>().size(), 2);
+}
+
+struct MembershipSystem : public CountingSystem
+{
+    using CountingSystem::GetSystemEntities;
+};
+
+///adds CustomComponent1 to other entity when it gets its first entity
+struct ReentrantSystem : public TestSystem
+{
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>;
+
+    ReentrantSystem(Manager* manager, MyECS::Entity other)
+        : TestSystem(MyECS::SystemComponents<int, std::string>{}), manager(manager), other(other) {}
+
+    void OnEntityAdditionAction(MyECS::Entity) override
+    {
+        if(count++ == 0)
+            manager->AddComponents<false, CustomComponent1>(other, {});
+    }
+
+    Manager* manager;
+    MyECS::Entity other;
+    int count{0};
+};
+
+struct IntSystem : public TestSystem
+{
+    IntSystem() : TestSystem(MyECS::SystemComponents<int>{}) {}
+
+    using TestSystem::GetSystemEntities;
+};
+
+TEST(SystemTest, NestedNotificationsDontDisturbOuterOne)
+{
+    auto man = std::make_unique<ReentrantSystem::Manager>();
+    const auto other = man->CreateEntity<false, int>(0);
+
+    auto* reentrant = man->CreateSystem<ReentrantSystem>(MyECS::SystemComponents<int, std::string>{}, man.get(), other);
+    auto* counting = man->CreateSystem<IntSystem>(MyECS::SystemComponents<int>{});
+
+    // reentrant system is visited first and changes other entity from its action
+    const auto entity = man->CreateEntity<false, int, std::string>(1, "");
+    ASSERT_EQ(reentrant->count, 1);
+    ASSERT_TRUE(man->HasComponent<CustomComponent1>(other));
+    ASSERT_EQ(counting->GetSystemEntities(), (std::vector<MyECS::Entity>{other, entity}));
+}
+
+TEST(SystemTest, MembershipFollowsComponentChanges)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    auto* system = man->CreateSystem<MembershipSystem>(MyECS::SystemComponents<CustomComponent2, int>{});
+
+    const auto first = man->CreateEntity<false, CustomComponent2, int>({}, 0);
+    const auto second = man->CreateEntity<false, int>(1);
+    man->CreateEntity<false, float>(0.0f);
+
+    ASSERT_EQ(system->GetSystemEntities(), std::vector<MyECS::Entity>{first});
+
+    man->AddComponents<false, CustomComponent2>(second, {});
+    man->DetachComponents<int>(first);
+    man->AddComponents<false, float>(second, 1.0f);
+    ASSERT_EQ(system->GetSystemEntities(), std::vector<MyECS::Entity>{second});
+    ASSERT_EQ(system->count, 1);
+
+    man->RemoveEntity(second);
+    ASSERT_EQ(system->GetSystemEntities().empty(), true);
+    ASSERT_EQ(system->count, 0);
+}
+
+TEST(EntityCreationTest, CreationFailsWhenCapacityRunsOut)
+{
+    auto man = std::make_unique<MyECS::EntityManager<4, COMPONENTS_COUNT, BitsStorageType>>();
+
+    std::vector<MyECS::Entity> entities;
+    for(int i{0}; i<4; ++i)
+        entities.push_back(man->CreateEntity<false, int>(int{i}));
+
+    ASSERT_EQ((man->CreateEntity<false, int>(4)), MyECS::InvalidEntity);
+    ASSERT_EQ(man->AliveEntitiesCount(), 4);
+    ASSERT_EQ(std::get<0>(man->GetEntityComponents<int>(entities[0])), 0);
+    ASSERT_FALSE(man->IsAlive(MyECS::InvalidEntity));
+
+    man->RemoveEntity(entities[1]);
+    const auto created = man->CreateEntities<false, int>(3, [](std::size_t i){ return std::tuple<int>{static_cast<int>(i)}; });
+    ASSERT_EQ(created.size(), 1);
+    ASSERT_EQ(man->GetComponents<int>().size(), 4);
+}
+
+TEST(EntityCreationTest, CreateEntitiesInBulk)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    auto* system = man->CreateSystem<CountingSystem>(MyECS::SystemComponents<CustomComponent2, int>{});
+
+    const auto entities = man->CreateEntities<true, CustomComponent3, int>(ENTITY_COUNT/4, [](std::size_t i){
+        return std::tuple<CustomComponent3, int>{CustomComponent3{}, static_cast<int>(i)};
+    });
+
+    ASSERT_EQ(entities.size(), ENTITY_COUNT/4);
+    ASSERT_EQ(system->count, 0);
+
+    man->AddComponentsBulk<false, CustomComponent2>(std::span{entities}.first(ENTITY_COUNT/8), [](std::size_t){
+        return std::tuple<CustomComponent2>{};
+    });
+
+    ASSERT_EQ(system->count, ENTITY_COUNT/8);
+
+    for(std::size_t i{0}; i<entities.size(); ++i)
+    {
+        ASSERT_EQ((man->HasComponents<CustomComponent3, int>(entities[i])), true);
+        ASSERT_EQ(man->HasComponent<CustomComponent2>(entities[i]), i < ENTITY_COUNT/8);
+        ASSERT_EQ((std::get<0>(man->GetEntityComponents<true, int>(entities[i]))), static_cast<int>(i));
+    }
+}
+
+struct CopyCountingComponent
+{
+    explicit CopyCountingComponent(int value = 0) : value(value) {}
+    CopyCountingComponent(const CopyCountingComponent& other) : value(other.value) { ++copies; }
+    CopyCountingComponent(CopyCountingComponent&&) noexcept = default;
+    CopyCountingComponent& operator=(const CopyCountingComponent& other) { value = other.value; ++copies; return *this; }
+    CopyCountingComponent& operator=(CopyCountingComponent&&) noexcept = default;
+
+    int value;
+    static inline int copies{0};
+};
+
+TEST(ComponentsStorageTest, AddAndEmplaceDoNotCopy)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    auto* system = man->CreateSystem<MembershipSystem>(MyECS::SystemComponents<CustomComponent2, int>{});
+    CopyCountingComponent::copies = 0;
+
+    std::vector<MyECS::Entity> entities;
+    for(int i{0}; i<ENTITY_COUNT/16; ++i)
+    {
+        entities.push_back(man->CreateEntity<false, CopyCountingComponent>(CopyCountingComponent{i}));
+        man->EmplaceComponent<false, CustomComponent2>(entities.back());
+        man->EmplaceComponent<true, std::string>(entities.back(), 8, 'x');
+    }
+
+    ASSERT_EQ(CopyCountingComponent::copies, 0);
+    ASSERT_EQ(system->count, 0);
+
+    man->EmplaceComponent<false, int>(entities.front(), 7);
+    ASSERT_EQ(system->GetSystemEntities(), std::vector<MyECS::Entity>{entities.front()});
+
+    for(int i{0}; i<ENTITY_COUNT/16; ++i)
+    {
+        ASSERT_EQ(std::get<0>(man->GetEntityComponents<CopyCountingComponent>(entities[i])).value, i);
+        ASSERT_EQ((std::get<0>(man->GetEntityComponents<true, std::string>(entities[i]))), "xxxxxxxx");
+    }
+}
+
+///counts bytes currently allocated through it, memory comes from new_delete_resource
+struct CountingResource : public std::pmr::memory_resource
+{
+    std::size_t allocated{0};
+    ///allocations which succeed before the resource starts throwing
+    std::size_t allocationsLeft{std::numeric_limits<std::size_t>::max()};
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if(allocationsLeft == 0)
+            throw std::bad_alloc{};
+
+        --allocationsLeft;
+        allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override
+    {
+        allocated -= bytes;
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+struct PmrComponent
+{
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    explicit PmrComponent(allocator_type allocator = {}) : values(32, allocator) {}
+    PmrComponent(const PmrComponent& other, allocator_type allocator = {}) : values(other.values, allocator) {}
+    PmrComponent(PmrComponent&& other, allocator_type allocator) : values(std::move(other.values), allocator) {}
+    PmrComponent(PmrComponent&&) = default;
+    PmrComponent& operator=(PmrComponent&&) = default;
+
+    std::pmr::vector<int> values;
+};
+
+TEST(ComponentsStorageTest, ComponentsUseManagerMemoryResource)
+{
+    CountingResource resource;
+    {
+        auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>(&resource);
+        const auto entities = man->CreateEntities<false, PmrComponent, int>(1000, [](std::size_t i){
+            return std::tuple<PmrComponent, int>{PmrComponent{}, static_cast<int>(i)};
+        });
+        man->EmplaceComponent<true, float>(entities[1], 1.0f);
+
+        ASSERT_GE(resource.allocated, 1000 * (sizeof(PmrComponent) + 32 * sizeof(int) + sizeof(int)) + sizeof(float));
+
+        const auto& components = man->GetComponents<PmrComponent>();
+        ASSERT_EQ(components.get_allocator().resource(), &resource);
+        ASSERT_EQ(components.back().values.get_allocator().resource(), &resource);
+
+        man->RemoveEntity(entities[0]);
+        ASSERT_EQ(components.front().values.get_allocator().resource(), &resource);
+        ASSERT_EQ(components.front().values.size(), 32);
+    }
+
+    ASSERT_EQ(resource.allocated, 0);
+}
+
+struct AdditionRecordingSystem : public TestSystem
+{
+    AdditionRecordingSystem() : TestSystem(MyECS::SystemComponents<CustomComponent2, int>{}) {}
+
+    void OnEntityAdditionAction(MyECS::Entity entity) override { added.push_back(entity); }
+
+    std::vector<MyECS::Entity> added;
+};
+
+TEST(SystemTest, PendingUpdatesAreMergedPerEntity)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    auto* system = man->CreateSystem<AdditionRecordingSystem>(MyECS::SystemComponents<CustomComponent2, int>{});
+
+    std::vector<MyECS::Entity> entities;
+    for(int i{0}; i<ENTITY_COUNT/16; ++i)
+    {
+        entities.push_back(man->CreateEntity<true, CustomComponent3>({}));
+        man->AddComponents<true, CustomComponent2>(entities.back(), {});
+        man->AddComponents<true, int>(entities.back(), int{i});
+        man->AddComponents<true, float>(entities.back(), 0.0f);
+    }
+
+    man->RemoveEntity(entities.front());
+    ASSERT_EQ(system->added.empty(), true);
+
+    man->ExecPendingUpdates();
+    std::sort(system->added.begin(), system->added.end());
+    ASSERT_EQ(system->added, std::vector<MyECS::Entity>(entities.begin() + 1, entities.end()));
+
+    man->ExecPendingUpdates();
+    ASSERT_EQ(system->added.size(), entities.size() - 1);
+}
+
+TEST(RegistryTest, RegisteredComponentsUseStaticIds)
+{
+    using Components = MyECS::Registry<CustomComponent1, int, CustomComponent2, MyECS::ThreadSafe<std::string>>;
+    static_assert(Components::IdOf<CustomComponent2> == 2);
+    static_assert(Components::ThreadSafeStorage<std::string> && !Components::ThreadSafeStorage<int>);
+
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType, Components>;
+    auto man = std::make_unique<Manager>();
+    auto* system = man->CreateSystem<CountingSystem>(MyECS::SystemComponents<CustomComponent2, int>{});
+
+    std::vector<MyECS::Entity> entities;
+    for(int i{0}; i<ENTITY_COUNT/16; ++i)
+        entities.push_back(man->CreateEntity<false, CustomComponent1, int>({}, int{i}));
+
+    for(std::size_t i{0}; i<entities.size(); i += 2)
+        man->AddComponents<false, CustomComponent2>(entities[i], {});
+
+    man->AddComponents<true, std::string>(entities[1], "str");
+    ASSERT_EQ(system->count, ENTITY_COUNT/32);
+    ASSERT_EQ((man->HasComponents<CustomComponent1, int>(entities[1])), true);
+    ASSERT_EQ((man->HasComponents<CustomComponent2, int>(entities[1])), false);
+    ASSERT_EQ((std::get<0>(man->GetEntityComponents<true, std::string>(entities[1]))), "str");
+    ASSERT_EQ(std::get<0>(man->GetEntityComponentsCopy<std::string>(entities[1])), "str");
+    ASSERT_EQ(man->ReadComponent<std::string>(entities[1], [](const std::string& value){ return value.size(); }), 3);
+
+    int sum{0};
+    for(const auto& [entity, c2, value] : man->GetView<CustomComponent2, int>())
+        sum += value;
+    ASSERT_EQ(sum, (ENTITY_COUNT/16 - 2) * (ENTITY_COUNT/32) / 2);
+
+    man->RemoveEntity(entities[0]);
+    man->DetachComponents<CustomComponent2>(entities[2]);
+    ASSERT_EQ(system->count, ENTITY_COUNT/32 - 2);
+    ASSERT_EQ(man->GetComponents<CustomComponent2>().size(), ENTITY_COUNT/32 - 2);
+    ASSERT_EQ(man->GetComponents<int>().size(), ENTITY_COUNT/16 - 1);
+}
+
+struct Stunned {};
+
+struct StunnedSystem : public TestSystem
+{
+    StunnedSystem() : TestSystem(MyECS::SystemComponents<Stunned, int>{}) {}
+
+    std::size_t Count() const { return GetSystemEntities().size(); }
+};
+
+TEST(ComponentsStorageTest, TagComponentsLiveOnlyInEntityBits)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    auto* system = man->CreateSystem<StunnedSystem>(MyECS::SystemComponents<Stunned, int>{});
+
+    const auto entities = man->CreateEntities<false, int, Stunned>(100, [](std::size_t i){
+        return std::tuple<int, Stunned>{static_cast<int>(i), {}};
+    });
+    ASSERT_EQ(system->Count(), 100);
+
+    man->DetachComponents<Stunned>(entities[0]);
+    man->DetachComponents<Stunned>(entities[1]);
+    man->DetachComponents<Stunned>(entities[2]);
+    man->EmplaceComponent<false, Stunned>(entities[1]);
+    man->AddComponents<true, Stunned>(entities[2], {});
+    man->ExecPendingUpdates();
+    ASSERT_EQ(system->Count(), 99);
+    ASSERT_FALSE(man->HasComponent<Stunned>(entities[0]));
+    ASSERT_TRUE((man->HasComponents<Stunned, int>(entities[1])));
+    ASSERT_TRUE(man->HasComponent<Stunned>(entities[2]));
+
+    man->RemoveEntity(entities[1]);
+    ASSERT_EQ(system->Count(), 98);
+
+    std::vector<std::byte> snapshot;
+    ASSERT_TRUE(man->SaveSnapshot(snapshot));
+    ASSERT_TRUE(man->LoadSnapshot(snapshot));
+    ASSERT_TRUE(man->HasComponent<Stunned>(entities[2]));
+    ASSERT_EQ(system->Count(), 98);
+    ASSERT_EQ(man->GetComponents<int>().size(), 99);
+
+    using Registered = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType, MyECS::Registry<int, Stunned>>;
+    auto registered = std::make_unique<Registered>();
+    const auto entity = registered->CreateEntity<false, int, Stunned>(1, {});
+    ASSERT_TRUE(registered->HasComponent<Stunned>(entity));
+    registered->RemoveEntity(entity);
+    ASSERT_TRUE(registered->GetComponents<int>().empty());
+}
+
+TEST(ViewTest, TagsFilterViewsWithoutYieldingReferences)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    const auto entities = man->CreateEntities<false, int>(10, [](std::size_t i){ return std::tuple<int>{static_cast<int>(i)}; });
+    for(std::size_t i{0}; i<entities.size(); i += 2)
+        man->AddComponents<false, Stunned>(entities[i], {});
+
+    auto view = man->GetView<int, Stunned>();
+    ASSERT_EQ(view.Size(), 5);
+    for(const auto [entity, value] : view)
+        ASSERT_EQ(value % 2, 0);
+
+    // tag changes invalidate cached entities even though no storage changed
+    man->DetachComponents<Stunned>(entities[0]);
+    ASSERT_EQ(view.Size(), 4);
+
+    int sum{0};
+    view.Each([&sum](MyECS::Entity, int& value){ sum += value; });
+    ASSERT_EQ(sum, 2 + 4 + 6 + 8);
+
+    auto stunned = man->GetView<Stunned>();
+    ASSERT_EQ(stunned.Size(), 4);
+    man->RemoveEntity(entities[2]);
+    ASSERT_EQ(stunned.Size(), 3);
+    ASSERT_EQ(view.Size(), 3);
+}
+
+struct InputState
+{
+    float cursorX{0.0f};
+    float cursorY{0.0f};
+};
+
+TEST(SingletonTest, SingletonsAreSetOncePerWorld)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    ASSERT_EQ(man->FindSingleton<InputState>(), nullptr);
+
+    man->SetSingleton<InputState>(1.0f, 2.0f);
+    man->GetSingleton<InputState>().cursorX = 3.0f;
+    ASSERT_EQ(std::as_const(*man).GetSingleton<InputState>().cursorX, 3.0f);
+
+    man->SetSingleton<std::string>("config");
+    man->SetSingleton<InputState>();
+    ASSERT_EQ(man->FindSingleton<InputState>()->cursorX, 0.0f);
+    ASSERT_EQ(man->GetSingleton<std::string>(), "config");
+
+    man->RemoveSingleton<InputState>();
+    ASSERT_EQ(man->FindSingleton<InputState>(), nullptr);
+    ASSERT_NE(man->FindSingleton<std::string>(), nullptr);
+}
+
+struct NamedValuesSystem : public TestSystem
+{
+    NamedValuesSystem() : TestSystem(MyECS::SystemComponents<std::string, int>{}) {}
+
+    void OnEntityAdditionAction(MyECS::Entity) override { ++count; }
+    void OnEntityRemovalAction(MyECS::Entity) override { --count; }
+
+    int count{0};
+};
+
+TEST(SnapshotTest, LoadRestoresWorldAndSystems)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    auto* system = man->CreateSystem<NamedValuesSystem>(MyECS::SystemComponents<std::string, int>{});
+
+    std::vector<MyECS::Entity> entities;
+    for(int i{0}; i<3000; ++i)
+    {
+        entities.push_back(man->CreateEntity<false, int>(int{i}));
+        if(i % 2 == 0)
+            man->AddComponents<false, CustomComponent1>(entities.back(), {});
+        if(i % 3 == 0)
+            man->AddComponents<false, std::string>(entities.back(), std::to_string(i));
+    }
+
+    for(std::size_t i{0}; i<entities.size(); i += 7)
+        man->RemoveEntity(entities[i]);
+
+    const auto savedAlive = std::vector<MyECS::Entity>(man->GetAliveEntities().begin(), man->GetAliveEntities().end());
+    const int savedCount = system->count;
+
+    std::vector<std::byte> snapshot;
+    ASSERT_TRUE(man->SaveSnapshot(snapshot));
+
+    const auto createdAfterSave = man->CreateEntity<false, std::string, int>("new", -1);
+    for(std::size_t i{1}; i<entities.size(); i += 5)
+        if(man->IsAlive(entities[i]))
+            man->RemoveEntity(entities[i]);
+    ASSERT_NE(system->count, savedCount);
+
+    ASSERT_TRUE(man->LoadSnapshot(snapshot));
+    ASSERT_EQ(std::vector<MyECS::Entity>(man->GetAliveEntities().begin(), man->GetAliveEntities().end()), savedAlive);
+    ASSERT_FALSE(man->IsAlive(createdAfterSave));
+    ASSERT_EQ(system->count, savedCount);
+    ASSERT_EQ((man->GetView<std::string, int>().Size()), savedCount);
+
+    for(const auto& [entity, name, value] : man->GetView<std::string, int>())
+        ASSERT_EQ(name, std::to_string(value));
+
+    ASSERT_EQ(man->CreateEntity<false>(), createdAfterSave);
+
+    ASSERT_FALSE(man->LoadSnapshot(std::span<const std::byte>{snapshot}.first(snapshot.size() / 2)));
+    man->AddComponents<false, CustomComponent2>(savedAlive.front(), {});
+    ASSERT_FALSE(man->SaveSnapshot(snapshot));
+}
+
+TEST(SnapshotTest, MappedFileRestoresRegisteredWorld)
+{
+    using Manager = MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType,
+                                         MyECS::Registry<int, CustomComponent1, MyECS::ThreadSafe<std::string>>>;
+    auto source = std::make_unique<Manager>();
+
+    const auto entities = source->CreateEntities<false, int, CustomComponent1>(ENTITY_COUNT/16, [](std::size_t i){
+        return std::tuple<int, CustomComponent1>{static_cast<int>(i), CustomComponent1{}};
+    });
+    source->AddComponents<true, std::string>(entities[5], "five");
+    source->RemoveEntity(entities[0]);
+
+    std::vector<std::byte> snapshot;
+    ASSERT_TRUE(source->SaveSnapshot(snapshot));
+
+    const auto path = testing::TempDir() + "myecs_snapshot.bin";
+    ASSERT_TRUE(MyECS::WriteSnapshotFile(path.c_str(), snapshot));
+
+    MyECS::MappedSnapshot mapped{path.c_str()};
+    ASSERT_TRUE(mapped.IsOpen());
+
+    auto restored = std::make_unique<Manager>();
+    ASSERT_TRUE(restored->LoadSnapshot(mapped.GetData()));
+    ASSERT_EQ(restored->AliveEntitiesCount(), ENTITY_COUNT/16 - 1);
+    ASSERT_FALSE(restored->IsAlive(entities[0]));
+    ASSERT_EQ((std::get<0>(restored->GetEntityComponents<true, std::string>(entities[5]))), "five");
+    ASSERT_EQ(std::get<0>(restored->GetEntityComponents<int>(entities[100])), 100);
+    ASSERT_EQ(restored->GetComponents<CustomComponent1>().size(), ENTITY_COUNT/16 - 1);
+
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotTest, CorruptedSnapshotIsRejected)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    std::vector<MyECS::Entity> entities;
+    for(int i{0}; i<4; ++i)
+        entities.push_back(man->CreateEntity<false, int>(int{i}));
+    man->RemoveEntity(entities[3]);
+
+    std::vector<std::byte> snapshot;
+    ASSERT_TRUE(man->SaveSnapshot(snapshot));
+
+    constexpr auto aliveOffset = sizeof(MyECS::SnapshotHeader);
+    constexpr auto freeOffset = aliveOffset + 3 * (sizeof(MyECS::Entity) + sizeof(MyECS::Bits<BitsStorageType, COMPONENTS_COUNT>));
+    constexpr auto storageEntitiesOffset = freeOffset + sizeof(MyECS::Entity) + sizeof(MyECS::SnapshotStorageHeader);
+
+    const auto corrupted = [&snapshot](std::size_t offset, auto value){
+        auto copy = snapshot;
+        std::memcpy(copy.data() + offset, &value, sizeof(value));
+        return copy;
+    };
+
+    // counts whose sum wraps around
+    const uint64_t half = uint64_t{1} << 63;
+    ASSERT_FALSE(man->LoadSnapshot(corrupted(offsetof(MyECS::SnapshotHeader, aliveCount), half)));
+    ASSERT_FALSE(man->LoadSnapshot(corrupted(offsetof(MyECS::SnapshotHeader, freeCount), half)));
+
+    // alive entity twice, free entity reusing alive slot, storage instance of removed entity
+    ASSERT_FALSE(man->LoadSnapshot(corrupted(aliveOffset + sizeof(MyECS::Entity), entities[0])));
+    ASSERT_FALSE(man->LoadSnapshot(corrupted(freeOffset, entities[1])));
+    ASSERT_FALSE(man->LoadSnapshot(corrupted(storageEntitiesOffset, entities[3])));
+    ASSERT_EQ(man->AliveEntitiesCount(), 0);
+
+    ASSERT_TRUE(man->LoadSnapshot(snapshot));
+    ASSERT_EQ(man->AliveEntitiesCount(), 3);
+    ASSERT_NE(man->CreateEntity<false>(), entities[1]);
+}
+
+TEST(ChangeTrackingTest, CollectChangesReturnsOnlyModifiedComponents)
+{
+    auto manager = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    manager->EnableChangeTracking<false, int>();
+
+    const auto entities = manager->CreateEntities<false, int, CustomComponent1>(1000, [](std::size_t i){
+        return std::tuple<int, CustomComponent1>{static_cast<int>(i), CustomComponent1{}};
+    });
+    manager->EnableChangeTracking<true, std::string>();
+
+    const auto initial = manager->CollectChanges(0);
+    ASSERT_EQ(initial.changed.size(), 1000);
+    ASSERT_TRUE(initial.removed.empty());
+
+    const auto since = manager->GetChangeTick();
+    manager->AdvanceChangeTick();
+    ASSERT_TRUE(manager->CollectChanges(since).changed.empty());
+
+    std::get<0>(manager->GetEntityComponents<int>(entities[10])) = -10;
+    manager->MarkChanged<int>(entities[700]);
+    manager->AddComponents<true, std::string>(entities[3], "three");
+    manager->RemoveEntity(entities[999]);
+    manager->RemoveEntity(entities[0]);
+
+    const auto changes = manager->CollectChanges(since);
+    const auto intId = static_cast<uint32_t>(MyECS::ID::get<int>());
+    const auto stringId = static_cast<uint32_t>(MyECS::ID::get<std::string>());
+
+    std::vector<MyECS::ComponentChange> expected{{entities[10], intId}, {entities[700], intId}, {entities[3], stringId}};
+    auto changed = changes.changed;
+    ASSERT_TRUE(std::is_permutation(changed.begin(), changed.end(), expected.begin(), expected.end()));
+
+    std::vector<MyECS::ComponentChange> expectedRemoved{{entities[999], intId}, {entities[0], intId}};
+    ASSERT_TRUE(std::is_permutation(changes.removed.begin(), changes.removed.end(), expectedRemoved.begin(), expectedRemoved.end()));
+
+    // entities[998] was swapped into the slot of entities[0] and kept its old tick
+    manager->DiscardChanges(manager->GetChangeTick());
+    const auto later = manager->AdvanceChangeTick();
+    ASSERT_TRUE(manager->CollectChanges(later - 1).changed.empty());
+    ASSERT_TRUE(manager->CollectChanges(since).removed.empty());
+    ASSERT_EQ(manager->CollectChanges(since).changed.size(), 3);
+}
+
+TEST(ComponentsStorageTest, SoAComponentsKeepMembersInSeparateArrays)
+{
+    auto manager = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    const auto entities = manager->CreateEntities<false, SoAParticle, int>(1000, [](std::size_t i){
+        return std::tuple<SoAParticle, int>{SoAParticle{static_cast<float>(i), 0.0f, static_cast<int>(i)}, static_cast<int>(i)};
+    });
+
+    auto [particle] = manager->GetEntityComponents<SoAParticle>(entities[10]);
+    particle.Get<&SoAParticle::y>() = 2.0f;
+    ASSERT_EQ(static_cast<SoAParticle>(particle).y, 2.0f);
+
+    // swap-and-pop moves every member of the last instance
+    manager->RemoveEntity(entities[0]);
+    ASSERT_EQ((std::get<0>(manager->GetEntityComponents<SoAParticle>(entities[999])).Get<&SoAParticle::id>()), 999);
+
+    auto& particles = manager->GetComponents<SoAParticle>();
+    const auto xs = particles.Field<&SoAParticle::x>();
+    ASSERT_EQ(xs.size(), 999);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(xs.data()) % MyECS::SoAVector<SoAParticle>::Alignment, 0);
+
+    manager->ParallelEach<SoAParticle>([](std::span<const MyECS::Entity>, MyECS::SoASpan<SoAParticle> chunk){
+        for(auto& x : chunk.Field<&SoAParticle::x>())
+            x += 1.0f;
+    });
+
+    std::size_t visited{0};
+    for(auto [entity, soaParticle, value] : manager->GetView<SoAParticle, int>())
+    {
+        ASSERT_EQ(soaParticle.Get<&SoAParticle::id>(), value);
+        ASSERT_EQ(soaParticle.Get<&SoAParticle::x>(), static_cast<float>(value) + 1.0f);
+        ++visited;
+    }
+    ASSERT_EQ(visited, 999);
+
+    std::vector<std::byte> snapshot;
+    ASSERT_TRUE(manager->SaveSnapshot(snapshot));
+    ASSERT_TRUE(manager->LoadSnapshot(snapshot));
+
+    const SoAParticle restored = std::get<0>(std::as_const(*manager).GetEntityComponents<false, SoAParticle>(entities[10]));
+    ASSERT_EQ(restored.x, 11.0f);
+    ASSERT_EQ(restored.y, 2.0f);
+    ASSERT_EQ(restored.id, 10);
+
+    // growth failing on the second member array keeps the members where they were, arrays are given back whole
+    CountingResource resource;
+    {
+        MyECS::SoAVector<SoAParticle> vector{&resource};
+        vector.push_back({1.0f, 2.0f, 3});
+        resource.allocationsLeft = 1;
+        ASSERT_THROW(vector.reserve(64), std::bad_alloc);
+        ASSERT_EQ(vector.capacity(), 8);
+        ASSERT_EQ(static_cast<SoAParticle>(vector[0]).id, 3);
+    }
+    ASSERT_EQ(resource.allocated, 0);
+}
+
+TEST(ComponentsStorageTest, CompactSortsStoragesAndShrinksThem)
+{
+    auto manager = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    std::vector<MyECS::Entity> entities;
+    for(int i{0}; i<3000; ++i)
+        entities.push_back(manager->CreateEntity<false, int, float>(int{i}, static_cast<float>(i)));
+
+    for(int i{2999}; i>=0; i -= 2)
+        manager->RemoveEntity(entities[i]);
+    for(int i{0}; i<3000; i += 4)
+        manager->RemoveEntity(entities[i]);
+
+    const auto isSorted = [](const auto& values, auto compare){ return std::is_sorted(values.begin(), values.end(), compare); };
+    ASSERT_FALSE(isSorted(manager->GetComponents<int>(), std::less<>{}));
+
+    manager->Compact();
+    ASSERT_EQ(manager->GetComponents<int>().size(), 750);
+    ASSERT_TRUE(isSorted(manager->GetComponents<int>(), std::less<>{}));
+    ASSERT_TRUE(isSorted(manager->GetComponents<float>(), std::less<>{}));
+    ASSERT_LT(manager->GetComponents<int>().capacity(), 1500);
+    ASSERT_EQ(std::get<0>(manager->GetEntityComponents<int>(entities[2])), 2);
+
+    // freed slots are reused lowest first
+    ASSERT_EQ(MyECS::GetEntityIndex(manager->CreateEntity<false>()), 0);
+    ASSERT_EQ(MyECS::GetEntityIndex(manager->CreateEntity<false>()), 1);
+
+    // floats are re-added in reverse, ints follow them
+    for(int i{2}; i<3000; i += 4)
+        manager->DetachComponents<float>(entities[i]);
+    for(int i{2998}; i>=0; i -= 4)
+        manager->AddComponents<false, float>(entities[i], static_cast<float>(i));
+
+    int steps{0};
+    while(!manager->DefragmentStep<float>(64))
+        ++steps;
+
+    ASSERT_GT(steps, 1);
+    const auto& ints = manager->GetComponents<int>();
+    const auto& floats = manager->GetComponents<float>();
+    ASSERT_TRUE(isSorted(floats, std::greater<>{}));
+    ASSERT_TRUE(std::equal(floats.begin(), floats.end(), ints.begin(), [](float f, int i){ return static_cast<int>(f) == i; }));
+}
+
+TEST(ObserverTest, EventsAreDispatchedInBatches)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+
+    std::vector<MyECS::Entity> added, removed, changed;
+    std::size_t addBatches{0};
+    man->OnAdd<int>([&](std::span<const MyECS::Entity> entities){ added.insert(added.end(), entities.begin(), entities.end()); ++addBatches; });
+    man->OnRemove<int>([&](std::span<const MyECS::Entity> entities){ removed.insert(removed.end(), entities.begin(), entities.end()); });
+    const auto onChange = man->OnChange<int>([&](std::span<const MyECS::Entity> entities){ changed.insert(changed.end(), entities.begin(), entities.end()); });
+
+    std::vector<MyECS::Entity> entities;
+    for(int i{0}; i<4; ++i)
+        entities.push_back(man->CreateEntity<false, int, std::string>(int{i}, ""));
+    man->DetachComponents<std::string>(entities[0]);
+
+    // nothing is delivered until dispatch, then every add comes in a single batch
+    ASSERT_TRUE(added.empty());
+    man->UpdateSystems();
+    ASSERT_EQ(added, entities);
+    ASSERT_EQ(addBatches, 1);
+
+    std::get<0>(man->GetEntityComponents<int>(entities[1])) = 10;
+    man->DetachComponents<int>(entities[2]);
+    man->RemoveEntity(entities[3]);
+    man->DispatchObservers();
+    ASSERT_EQ(changed, std::vector<MyECS::Entity>{entities[1]});
+    ASSERT_EQ(removed, (std::vector<MyECS::Entity>{entities[2], entities[3]}));
+
+    ASSERT_TRUE(man->RemoveObserver(onChange));
+    ASSERT_FALSE(man->RemoveObserver(onChange));
+    man->GetEntityComponents<int>(entities[1]);
+    man->DispatchObservers();
+    ASSERT_EQ(changed.size(), 1);
+    ASSERT_EQ(addBatches, 1);
+}
+
+TEST(ObserverTest, InterleavedEventsReachEveryObserverOnce)
+{
+    auto man = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    const auto entities = man->CreateEntities<false, std::string>(8, [](std::size_t){ return std::tuple<std::string>{}; });
+
+    std::size_t addCalls{0}, removeCalls{0}, addedCount{0}, removedCount{0};
+    man->OnAdd<int>([&](std::span<const MyECS::Entity> batch){ ++addCalls; addedCount += batch.size(); });
+    man->OnRemove<int>([&](std::span<const MyECS::Entity> batch){ ++removeCalls; removedCount += batch.size(); });
+
+    // add and remove alternate, yet every observer is called once per dispatch
+    for(const auto entity : entities)
+    {
+        man->AddComponents<false, int>(entity, 0);
+        man->DetachComponents<int>(entity);
+    }
+    man->DispatchObservers();
+
+    ASSERT_EQ(addCalls, 1);
+    ASSERT_EQ(removeCalls, 1);
+    ASSERT_EQ(addedCount, entities.size());
+    ASSERT_EQ(removedCount, entities.size());
+}
+
+#ifdef MYECS_INSTRUMENTATION
+TEST(InstrumentationTest, StatsAndTraceDescribeWorld)
+{
+    auto manager = std::make_unique<MyECS::EntityManager<ENTITY_COUNT, COMPONENTS_COUNT, BitsStorageType>>();
+    std::atomic<int> counter{0};
+    int order{0};
+    manager->CreateSystem<OrderRecordingSystem<MyECS::Write<int>>>(MyECS::SystemComponents<MyECS::Write<int>>{}, counter, order);
+
+    std::vector<MyECS::Entity> entities;
+    for(int i{0}; i<100; ++i)
+        entities.push_back(manager->CreateEntity<false, int>(int{i}));
+    for(int i{0}; i<10; ++i)
+        manager->AddComponents<true, std::string>(entities[i], "value");
+    for(int i{0}; i<50; ++i)
+        manager->RemoveEntity(entities[i]);
+
+    const auto stats = manager->GetStats();
+    ASSERT_EQ(stats.aliveEntities, 50);
+    ASSERT_EQ(stats.freeEntities, 50);
+    ASSERT_EQ(stats.systemsCount, 1);
+    ASSERT_GT(stats.entityTableBytes, 0);
+    ASSERT_GT(stats.entityTableFragmentation, 0.0);
+    ASSERT_EQ(stats.Get(MyECS::Operation::CreateEntity).count, 100);
+    ASSERT_EQ(stats.Get(MyECS::Operation::AddComponents).count, 10);
+    ASSERT_EQ(stats.Get(MyECS::Operation::RemoveEntity).count, 50);
+    ASSERT_LE(stats.Get(MyECS::Operation::CreateEntity).Percentile(0.5), stats.Get(MyECS::Operation::CreateEntity).Percentile(0.99));
+
+    ASSERT_EQ(stats.storages.size(), 2);
+    for(const auto& storage : stats.storages)
+    {
+        ASSERT_EQ(storage.threadSafe, storage.componentId == MyECS::ID::get<std::string>());
+        ASSERT_LE(storage.size, storage.capacity);
+        ASSERT_GE(storage.instancesBytes, storage.size * storage.componentSize);
+    }
+
+    manager->ResetStats();
+    ASSERT_EQ(manager->GetStats().Get(MyECS::Operation::CreateEntity).count, 0);
+
+    auto& trace = manager->GetTraceRecorder();
+    manager->UpdateSystems();
+    ASSERT_EQ(trace.EventsCount(), 0);
+
+    trace.Start();
+    manager->UpdateSystems();
+    manager->UpdateSystems();
+    trace.Stop();
+
+    // every frame records itself and the only system
+    ASSERT_EQ(trace.EventsCount(), 4);
+    const auto json = trace.ToChromeTraceJson();
+    ASSERT_NE(json.find("\"traceEvents\""), std::string::npos);
+    ASSERT_NE(json.find("\"name\":\"Frame\""), std::string::npos);
+}
+#endif
+
 class derivedSystem : public MyECS::System<64, uint64_t>
 {
 public: